@@ -89,11 +89,15 @@ protected:
         return QApplicationContext::delegateRegisterService(m_delegate, name, descriptor, config, scope, condition, baseObject);
     }
 
+    QList<service_registration_handle_t> registerServiceHandles(const std::vector<detail::service_declaration>& declarations) override {
+        return QApplicationContext::delegateRegisterServices(m_delegate, declarations);
+    }
+
     proxy_registration_handle_t getRegistrationHandle(const std::type_info &service_type, const QMetaObject *metaObject) const override {
         return QApplicationContext::delegateGetRegistrationHandle(m_delegate, service_type, metaObject);
     }
 
-    service_registration_handle_t getRegistrationHandle(const QString &name) const override {
+    service_registration_handle_t getRegistrationHandle(QAnyStringView name) const override {
         return QApplicationContext::delegateGetRegistrationHandle(m_delegate, name);
     }
 
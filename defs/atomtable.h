@@ -0,0 +1,51 @@
+#pragma once
+#include <QAnyStringView>
+#include <QString>
+#include <unordered_map>
+
+namespace mcnepp::qtdi::detail {
+
+///
+/// \brief An interned String.
+/// <br>Two atoms that were obtained from the same AtomTable are equal if and only if the Strings they were obtained for are equal.
+/// Thus, atoms may be hashed and compared by pointer.
+///
+using atom_t = const QString*;
+
+///
+/// \brief A table of interned Strings.
+/// <br>Every String is hashed once when it is interned. Subsequent look-ups accept any kind of String-view
+/// and do not need to allocate a QString.
+/// <br>Atoms remain valid for the lifetime of the AtomTable.
+/// <br>**Thread-safety:** An AtomTable is not synchronized. Concurrent invocations of find() are safe as long as no
+/// thread invokes intern().
+///
+class AtomTable final {
+public:
+
+    ///
+    /// \brief Obtains the atom for a String, creating it if necessary.
+    /// \param str the String to intern.
+    /// \return the atom for the supplied String. Will never be `nullptr`.
+    ///
+    atom_t intern(QAnyStringView str);
+
+    ///
+    /// \brief Obtains the atom for a String, if it has been interned before.
+    /// <br>This function never allocates, unless the supplied String is a non-ASCII UTF-8 String.
+    /// \param str the String to look up.
+    /// \return the atom for the supplied String, or `nullptr` if the String has never been interned.
+    ///
+    [[nodiscard]] atom_t find(QAnyStringView str) const;
+
+    [[nodiscard]] std::size_t size() const {
+        return m_atoms.size();
+    }
+
+private:
+    static std::size_t hash(QAnyStringView str);
+
+    std::unordered_multimap<std::size_t,const QString> m_atoms;
+};
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "qapplicationcontext.h"
+#include <QSettings>
+#include <QFile>
+#include <QDateTime>
+#include <QReadWriteLock>
+#include <memory>
+
+namespace mcnepp::qtdi {
+
+///
+/// \brief Obtains a QSettings::Format for INI-files that will be read through a compiled binary image.
+/// <br>When a QSettings-object with this format reads an INI-file, it first looks for a compiled image next to it, with the suffix `.qtdicache` appended.
+/// If the image is up-to-date (i.e. it was compiled from a source-file with the same size and modification-time), it will be memory-mapped and decoded.
+/// Otherwise, the INI-file will be parsed with the syntax of QSettings::IniFormat and the image will be (re-)compiled, so that subsequent reads,
+/// even by other processes, can skip parsing.
+/// <br>The image consists of a sorted index of keys, a table of the keys' UTF-16 data and the values serialized using QDataStream.
+/// It uses the native byte-order, as it is meant to be read only on the machine where it was compiled.
+/// The image is mapped only while its entries are being decoded into the QSettings.
+/// In order to look up entries in the mapped image without decoding all of them, use QCompiledIniConfigurationSource instead.
+/// <br>**Note:** QSettings shares the parsed data of a file among all instances within a process, regardless of their format.
+/// Thus, the same file should not be accessed with another format, e.g. QSettings::IniFormat, within the same process.
+/// <br>QSettings-objects with this format are read-only. Invoking QSettings::setValue() will result in QSettings::AccessError upon QSettings::sync().
+/// <br>Example:
+///
+///     QSettings settings{"app.ini", mcnepp::qtdi::compiledIniFormat()};
+///     context->registerObject(&settings);
+///
+/// **Thread-safety:** This function may be called safely from any thread.
+/// \return the Format for compiled INI-files.
+///
+QSettings::Format compiledIniFormat();
+
+///
+/// \brief A QConfigurationSource that looks up configuration-entries in the compiled image of an INI-file.
+/// <br>The INI-file will be compiled in the same way as for compiledIniFormat(). However, the image will stay memory-mapped for the lifetime of this source.
+/// A lookup performs a binary search in the image's sorted index and decodes only the value that was found.
+/// Thus, no memory will be allocated for entries that are never requested, and the pages of the image may be shared with other processes.
+/// <br>If the image cannot be written, the parsed entries will be held in memory instead.
+/// <br>Example:
+///
+///     context->registerObject(new QCompiledIniConfigurationSource{"application.ini", context});
+///
+class QCompiledIniConfigurationSource : public QConfigurationSource {
+    Q_OBJECT
+public:
+    ///
+    /// \brief Creates a QCompiledIniConfigurationSource and maps the image of the file.
+    /// <br>If the image is missing or outdated, the file will be compiled first. If the file does not exist, the source will be empty.
+    /// \param fileName the name of the INI-file.
+    /// \param parent the parent of this source.
+    ///
+    explicit QCompiledIniConfigurationSource(const QString& fileName, QObject* parent = nullptr);
+
+    ~QCompiledIniConfigurationSource() override;
+
+    QVariant value(const QString& key) const override;
+
+    QStringList allKeys() const override;
+
+    QString fileName() const override;
+
+    bool hasFile() const override;
+
+    ///
+    /// \brief Maps the image again, if the file has been modified.
+    /// <br>The image will be compiled again before it is mapped.
+    ///
+    void refresh() override;
+
+    ///
+    /// \brief Creates a source for profile-specific configuration-entries.
+    /// \return a QCompiledIniConfigurationSource for the file with the same base-name with a dash and the name of the profile appended, followed by the original suffix.
+    ///
+    QConfigurationSource* createForProfile(const QString& profile, QObject* parent) const override;
+
+private:
+    void load();
+
+    const QString m_fileName;
+    mutable QReadWriteLock m_lock;
+    std::unique_ptr<QFile> m_image;
+    // The sections of the mapped image. m_data is nullptr if the entries are held in m_fallback:
+    const uchar* m_data = nullptr;
+    quint32 m_entryCount = 0;
+    qint64 m_keyTableStart = 0;
+    qint64 m_valueBlobStart = 0;
+    QSettings::SettingsMap m_fallback;
+    QDateTime m_lastModified;
+    qint64 m_size = -1;
+};
+
+}
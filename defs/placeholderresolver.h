@@ -1,14 +1,32 @@
 #pragma once
 #include "qapplicationcontext.h"
-#include <deque>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <QReadWriteLock>
 
 namespace mcnepp::qtdi::detail {
 
+///
+/// \brief The configuration-values that are needed by a batch of PlaceholderResolvers.
+/// <br>First, the keys of all PlaceholderResolvers are collected using PlaceholderResolver::collectKeys(placeholder_batch&) const.
+/// Then, the values of all keys are looked up in one pass. Finally, each PlaceholderResolver is resolved
+/// using PlaceholderResolver::resolve(const placeholder_batch&, QVariantMap&) const.
+///
+struct placeholder_batch {
+    /// The group, with all placeholders already resolved.
+    QString group;
+    /// The values, keyed by their configuration-path. Paths that shall also be searched in parent-sections start with `*/`.
+    QHash<QString,QVariant> values;
+};
+
 ///
 /// \brief Resolves placeholders via the QApplicationContext's configuraton.
-/// <br>Instances are created using the static function parse(const QString&, QObject*, const QLoggingCategory& loggingCategory)
+/// <br>Instances are created using the static function parse(const QString&, QApplicationContext*).
+/// <br>A PlaceholderResolver is immutable. Thus, it may be used from any thread.
 ///
-class PlaceholderResolver : public QObject {
+class PlaceholderResolver {
 
 public:
 
@@ -19,13 +37,45 @@ public:
         return resolve(group, resolvedPlaceholders);
     }
 
+    ///
+    /// \brief Resolves the placeholders using configuration-values that have been looked up in advance.
+    /// \param batch must contain the values of all keys that have been added by collectKeys(placeholder_batch&) const.
+    /// \param resolvedPlaceholders will be searched for placeholders that have no value in the batch.
+    ///
+    QVariant resolve(const placeholder_batch& batch, QVariantMap& resolvedPlaceholders) const;
+
+    ///
+    /// \brief Stores the values of all placeholders from the batch in the resolvedPlaceholders.
+    /// <br>This has the same effect on the resolvedPlaceholders as resolve(const placeholder_batch&, QVariantMap&) const,
+    /// provided that the batch contains a valid value for every placeholder.
+    ///
+    void storePlaceholders(const placeholder_batch& batch, QVariantMap& resolvedPlaceholders) const;
+
+    ///
+    /// \brief Adds the configuration-paths of all placeholders to the batch.
+    /// <br>The values of the added paths will be invalid.
+    ///
+    void collectKeys(placeholder_batch& batch) const;
+
     bool hasPlaceholders() const;
 
     bool hasPlaceholder(const QString&) const;
 
+    ///
+    /// \brief Obtains the keys of all placeholders, in the order of their appearance.
+    /// \return the keys of all placeholders, without wildcards and default-values.
+    ///
+    QStringList placeholders() const;
+
     void clearPlaceholders(QVariantMap& resolvedPlaceholders) const;
 
-    static PlaceholderResolver* parse(const QString& placeholderString, QApplicationContext* parent);
+    ///
+    /// \brief Parses an expression.
+    /// \param placeholderString the expression.
+    /// \param context will be used to look up configuration-values. Must outlive the returned PlaceholderResolver.
+    /// \return the parsed PlaceholderResolver, or `nullptr` if the expression is not valid.
+    ///
+    static std::unique_ptr<PlaceholderResolver> parse(const QString& placeholderString, QApplicationContext* context);
 
     ///
     /// \brief Is the supplied expression a literal?
@@ -44,26 +94,66 @@ public:
 
 private:
 
-    struct resolvable_step {
-        virtual ~resolvable_step() = default;
-        virtual QVariant resolve(QApplicationContext* appContext, const QString& group, QVariantMap& resolvedPlaceholders) = 0;
-        virtual QString placeholder() const = 0;
+    // A single instruction of a compiled expression: either a literal slice or a reference to a configuration-key.
+    struct instruction {
+        bool isPlaceholder;
+        bool hasWildcard;
+        // The literal, or the key of the placeholder:
+        QString text;
+        QString defaultValue;
     };
 
-    PlaceholderResolver(const QString& placeholderText, QApplicationContext* parent, std::deque<std::unique_ptr<resolvable_step>>&&);
+    // Yields the path of the instruction's key within the batch.
+    static QString batchKey(const instruction& instr, const QString& resolvedGroup);
+
+    // Falls back to the resolvedPlaceholders and the default-value if the placeholder has not been found in the configuration.
+    QVariant resolvePlaceholder(const instruction& instr, QVariant resolved, QVariantMap& resolvedPlaceholders) const;
 
-    struct literal_step;
+    template<typename F> QVariant resolveInstructions(F lookup, QVariantMap& resolvedPlaceholders) const;
 
-    struct placeholder_step;
+    static void addLiteral(std::vector<instruction>& instructions, const QString& literal);
 
-    static std::unique_ptr<resolvable_step> addStep(const QString& literal);
+    static void addPlaceholder(std::vector<instruction>& instructions, const QString& placeholder, const QString& defaultValue, bool hasWildcard);
 
-    static std::unique_ptr<resolvable_step> addStep(const QString& placeholder, const QString& defaultValue, bool hasWildcard);
+    PlaceholderResolver(const QString& placeholderText, QApplicationContext* context, std::vector<instruction>&&);
 
     QApplicationContext* const m_context;
     QString m_placeholderText;
-    std::deque<std::unique_ptr<resolvable_step>> m_steps;
+    std::vector<instruction> m_instructions;
+    // The sum of the lengths of all literals:
+    qsizetype m_literalLength = 0;
+    bool m_hasPlaceholders = false;
     const QLoggingCategory& m_loggingCategory;
 };
 
+///
+/// \brief Caches parsed PlaceholderResolvers.
+/// <br>The cache is divided into shards, each guarded by its own lock. Thus, it may be used from any thread
+/// with little contention. Cached PlaceholderResolvers will be kept until the cache is destroyed.
+///
+class ResolverCache {
+public:
+    explicit ResolverCache(QApplicationContext* context);
+
+    ResolverCache(const ResolverCache&) = delete;
+
+    ///
+    /// \brief Obtains the PlaceholderResolver for an expression.
+    /// <br>If the expression has not been cached yet, it will be parsed in the calling thread.
+    /// \return the cached PlaceholderResolver, or `nullptr` if the expression is not valid.
+    ///
+    const PlaceholderResolver* get(const QString& expression);
+
+private:
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+    struct shard {
+        QReadWriteLock lock;
+        std::unordered_map<QString,std::unique_ptr<const PlaceholderResolver>> resolvers;
+    };
+
+    QApplicationContext* const m_context;
+    std::array<shard,SHARD_COUNT> m_shards;
+};
+
 }
@@ -78,7 +78,7 @@ using subscription_handle_t = detail::Subscription*;
  * @brief Specifies the scope of a ServiceRegistration.
  * <br>Serves as a non-type template-argument for ServiceRegistration.
  * <table><tr><th>Scope</th><th>Produced by</th><th>Behaviour</th></tr>
- * <tr><td>UNKNOWN</td><td>QApplicationContext::getRegistrations(), QApplicationContext::getRegistration(const QString&).</td><td>Could be either SINGLETON or PROTOTYPE.</td></tr>
+ * <tr><td>UNKNOWN</td><td>QApplicationContext::getRegistrations(), QApplicationContext::getRegistration(QAnyStringView).</td><td>Could be either SINGLETON or PROTOTYPE.</td></tr>
  * <tr><td>SINGLETON</td><td>QApplicationContext::registerService(service()).</td><td>The service will be instantiated on QApplicationContext::publish(bool).<br>A reference to a single instance will be injected into every dependent service.</td></tr>
  * <tr><td>PROTOTYPE</td><td>QApplicationContext::registerService(prototype()).</td><td>Instances of this service will only be created if another service needs it as a dependency.<br>
  * A new instance will be injected into every dependent service.</td></tr>
@@ -1004,7 +1004,8 @@ protected:
 
 
         friend inline bool operator==(const service_config& left, const service_config& right) {
-            return left.properties == right.properties && left.group == right.group && left.autowire == right.autowire && left.autoRefresh == right.autoRefresh && left.serviceGroupPlaceholder == right.serviceGroupPlaceholder;
+            return left.properties == right.properties && left.group == right.group && left.autowire == right.autowire && left.autoRefresh == right.autoRefresh && left.serviceGroupPlaceholder == right.serviceGroupPlaceholder
+                   && left.concurrentCreation == right.concurrentCreation && left.lazy == right.lazy;
         }
 
 
@@ -1040,6 +1041,16 @@ protected:
         /// \brief the name of the placeholder for service-groups.
         ///
         QString serviceGroupPlaceholder;
+
+        ///
+        /// \brief May the service be instantiated concurrently with other services?
+        ///
+        bool concurrentCreation = false;
+
+        ///
+        /// \brief Shall the service be instantiated only when it is needed for the first time?
+        ///
+        bool lazy = false;
     };
 
     inline service_config merge_config(const service_config& first, const service_config& second) {
@@ -1052,6 +1063,8 @@ protected:
         }
         merged.autoRefresh |= second.autoRefresh;
         merged.autowire |= second.autowire;
+        merged.concurrentCreation |= second.concurrentCreation;
+        merged.lazy |= second.lazy;
         merged.properties.insert(second.properties);
 
         return merged;
@@ -2735,6 +2748,48 @@ inline void withAutowire(detail::service_config& cfg) {
     cfg.autowire = true;
 };
 
+///
+/// \brief Allows a service to be instantiated concurrently with other services.
+/// <br>This function is not meant to be invoked directly.
+/// <br>Rather, its usage is analogous to that of *iostream-manipulators* from the standard-library:
+///
+///
+///     context->registerService(service<DatabaseConnection>() << withConcurrentCreation);
+///
+/// When QApplicationContext::publish(bool) is invoked, the constructors of all such services that do not depend on each other
+/// will be invoked concurrently, using the global QThreadPool. Afterwards, the services will be moved to the ApplicationContext's thread.
+/// <br>Configuration, initialization and publication of the services will take place in the ApplicationContext's thread, as usual.
+/// <br>This is useful for services whose constructors spend considerable time doing I/O.
+///
+/// **Note:** The ApplicationContext's thread will be blocked while the constructors are running. Thus, a constructor must not rely on
+/// the event-loop of that thread, nor must it use any of its dependencies as the parent of the new service.
+/// <br>Services that have a dependency created by mcnepp::qtdi::injectParent() will always be instantiated in the ApplicationContext's thread.
+///
+inline void withConcurrentCreation(detail::service_config& cfg) {
+    cfg.concurrentCreation = true;
+};
+
+///
+/// \brief Defers the instantiation of a service until it is needed for the first time.
+/// <br>This function is not meant to be invoked directly.
+/// <br>Rather, its usage is analogous to that of *iostream-manipulators* from the standard-library:
+///
+///
+///     context->registerService(service<ReportGenerator>() << withLazyCreation, "reportGenerator");
+///
+/// When QApplicationContext::publish(bool) is invoked, the dependencies of such a service will be validated and resolved, as usual.
+/// However, the service will not be instantiated. Instead, it will be instantiated, configured, initialized and published when
+/// - it is injected into another service, either directly or as one of several services (see mcnepp::qtdi::injectAll()),
+/// - or when somebody subscribes to its ServiceRegistration (or to a ProxyRegistration that comprises it) in the ApplicationContext's thread after QApplicationContext::publish(bool) has been invoked.
+///
+/// Until then, the service will be counted neither by QApplicationContext::published() nor by QApplicationContext::pendingPublication().
+/// <br>**Note:** This applies to services with ServiceScope::SINGLETON only. Services of type QSettings will always be instantiated immediately.
+/// <br>A service that has not been instantiated yet cannot be a candidate for auto-wiring.
+///
+inline void withLazyCreation(detail::service_config& cfg) {
+    cfg.lazy = true;
+};
+
 
 ///
 /// \brief Sets the group for a service_config.
@@ -2744,6 +2799,8 @@ inline void withAutowire(detail::service_config& cfg) {
 ///
 /// \param groupExpression the group to use. This expression may contain *placeholders*, which will be resolved against the configuration at the time
 /// the service is published.
+/// <br>The group will be resolved once, before any property of the service. Thus, its *placeholders* will be resolved against the configuration and
+/// the private properties of the service (see mcnepp::qtdi::placeholderValue()), but not against *placeholders* that have been resolved by its properties.
 inline detail::service_config::config_modifier withGroup(const QString& groupExpression) {
     return [groupExpression](detail::service_config& cfg) { cfg.group = groupExpression;};
 }
@@ -3739,6 +3796,92 @@ template<typename S=QObject,typename Impl=S>  [[nodiscard]] Service<S,Impl,Servi
     return Service<S,Impl,ServiceScope::TEMPLATE>{detail::make_descriptor<S,Impl,ServiceScope::TEMPLATE>(nullptr)};
 }
 
+namespace detail {
+
+///
+/// \brief Comprises all arguments of QApplicationContext::registerServiceHandle().
+///
+struct service_declaration {
+    QString name;
+    service_descriptor descriptor;
+    service_config config;
+    ServiceScope scope;
+    Condition condition;
+    QObject* baseObject;
+};
+
+}
+
+///
+/// \brief Collects services that shall be registered with a QApplicationContext at once.
+/// <br>Use the function QApplicationContext::registerServices(const RegistrationBatch&) for registering all collected services:
+///
+///     RegistrationBatch batch;
+///     batch.add(service<QNetworkAccessManager>(), "networkManager");
+///     batch.add(service<PropFetcher,RestPropFetcher>(inject<QNetworkAccessManager>()), "hamburgWeather");
+///     auto registrations = context->registerServices(batch);
+///
+class RegistrationBatch final {
+public:
+
+    ///
+    /// \brief Adds a service to this batch.
+    /// \param serviceDeclaration comprises the services's primary advertised interface, its implementation-type and its dependencies to be injected
+    /// via its constructor.
+    /// \param objectName the name that the service shall have. If empty, a name will be auto-generated.
+    /// \param condition determines whether the service will become active on publication.
+    /// \return this RegistrationBatch.
+    ///
+    template<typename S,typename Impl,ServiceScope scope> RegistrationBatch& add(const Service<S,Impl,scope>& serviceDeclaration, const QString& objectName = {}, const Condition& condition = Condition::always()) {
+        m_declarations.push_back(detail::service_declaration{objectName, serviceDeclaration.descriptor, serviceDeclaration.config, scope, condition, nullptr});
+        return *this;
+    }
+
+    ///
+    /// \brief Adds a service that inherits from a service-template to this batch.
+    /// \param serviceDeclaration comprises the services's primary advertised interface, its implementation-type and its dependencies to be injected
+    /// via its constructor.
+    /// \param templateRegistration the registration of the service-template that this service shall inherit from. Must be valid!
+    /// \param objectName the name that the service shall have. If empty, a name will be auto-generated.
+    /// \param condition determines whether the service will become active on publication.
+    /// \return this RegistrationBatch.
+    ///
+    template<typename S,typename Impl,typename B,ServiceScope scope> RegistrationBatch& add(const Service<S,Impl,scope>& serviceDeclaration, const ServiceRegistration<B,ServiceScope::TEMPLATE>& templateRegistration, const QString& objectName = {}, const Condition& condition = Condition::always()) {
+        static_assert(std::is_base_of_v<B,Impl>, "Service-type does not extend type of Service-template.");
+        if(!templateRegistration) {
+            ++m_invalidTemplates;
+        }
+        m_declarations.push_back(detail::service_declaration{objectName, serviceDeclaration.descriptor, serviceDeclaration.config, scope, condition, templateRegistration.unwrap()});
+        return *this;
+    }
+
+    ///
+    /// \brief Have all services been added with valid arguments?
+    /// \return `false` if a service has been added with an invalid service-template.
+    ///
+    [[nodiscard]] bool isValid() const {
+        return m_invalidTemplates == 0;
+    }
+
+    ///
+    /// \return the number of services that have been added.
+    ///
+    [[nodiscard]] std::size_t size() const {
+        return m_declarations.size();
+    }
+
+    ///
+    /// \return the services that have been added, in the order of their addition.
+    ///
+    [[nodiscard]] const std::vector<detail::service_declaration>& declarations() const {
+        return m_declarations;
+    }
+
+private:
+    std::vector<detail::service_declaration> m_declarations;
+    unsigned m_invalidTemplates = 0;
+};
+
 ///
 /// \brief Watches a configuration-value.
 /// <br>Instances will be returned from QApplicationContext::watchConfigValue(const QString&).
@@ -3771,6 +3914,65 @@ protected:
     }
 };
 
+///
+/// \brief A source of configuration-entries.
+/// <br>Every QConfigurationSource that has been registered with a QApplicationContext will be consulted when resolving placeholders,
+/// in the same way as a registered QSettings.
+/// <br>Keys are delimited by forward slashes, in analogy to QSettings. The configuration-entries `"qtdi/*"` (such as `"qtdi/enableAutoRefresh"`)
+/// will be honoured for every QConfigurationSource.
+/// <br>**Thread-safety:** value(const QString&) and allKeys() may be invoked from any thread.
+///
+class QConfigurationSource : public QObject {
+    Q_OBJECT
+public:
+    ///
+    /// \brief Obtains the value for a key.
+    /// \param key the key, with sections delimited by forward slashes.
+    /// \return the value, or an invalid QVariant if this source does not contain the key.
+    ///
+    [[nodiscard]] virtual QVariant value(const QString& key) const = 0;
+
+    ///
+    /// \brief Obtains all keys of this source.
+    /// \return all keys of this source, including their sections.
+    ///
+    [[nodiscard]] virtual QStringList allKeys() const = 0;
+
+    ///
+    /// \brief Obtains the name of the file that backs this source.
+    /// <br>The name will also be used in order to identify this source in log-messages.
+    /// \return the name of the file that backs this source.
+    ///
+    [[nodiscard]] virtual QString fileName() const = 0;
+
+    ///
+    /// \brief Shall auto-refresh watch fileName() for modifications?
+    /// <br>If this function returns `false`, refresh() will be invoked periodically instead.
+    /// \return `true` if fileName() denotes a file that can be watched.
+    ///
+    [[nodiscard]] virtual bool hasFile() const = 0;
+
+    ///
+    /// \brief Re-reads the configuration-entries from the underlying storage.
+    /// <br>This function will be invoked in the ApplicationContext's thread, if auto-refresh has been enabled.
+    ///
+    virtual void refresh() = 0;
+
+    ///
+    /// \brief Creates a source with profile-specific configuration-entries.
+    /// <br>This function will be invoked for each active profile if this source contains the configuration-entry `"qtdi/enableProfileSpecificSettings"`.
+    /// \param profile the name of the profile.
+    /// \param parent the parent of the new source.
+    /// \return a new source for the profile, or `nullptr` if this source does not support profile-specific configuration-entries.
+    ///
+    [[nodiscard]] virtual QConfigurationSource* createForProfile(const QString& profile, QObject* parent) const = 0;
+
+protected:
+    explicit QConfigurationSource(QObject* parent = nullptr) : QObject{parent} {
+
+    }
+};
+
 
 
 
@@ -3883,6 +4085,30 @@ public:
         return ServiceRegistration<S,scope>::wrap(registerServiceHandle(objectName, serviceDeclaration.descriptor, serviceDeclaration.config, scope, condition, templateRegistration.unwrap()));
     }
 
+    ///
+    /// \brief Registers all services of a RegistrationBatch with this ApplicationContext.
+    /// <br>The services will be registered atomically: either all of them will be registered, or none of them.
+    /// Conflicts and cyclic dependencies will be detected as if the services had been registered one by one, in the order of the batch.
+    /// <br>The signal pendingPublicationChanged() will be emitted only once.
+    /// <br>**Note:** Atomicity is guaranteed by StandardApplicationContext. Other implementations of QApplicationContext
+    /// may register the services one by one (see registerServiceHandles(const std::vector<detail::service_declaration>&)).
+    /// <br>**Thread-safety:** This function may only be called from the ApplicationContext's thread.
+    /// \param batch the services to be registered.
+    /// \return the Registrations in the order of the batch, or an empty QList if the services could not be registered.
+    /// You may convert each Registration to a more specific type using ServiceRegistration::wrap(service_registration_handle_t).
+    ///
+    QList<ServiceRegistration<QObject,ServiceScope::UNKNOWN>> registerServices(const RegistrationBatch& batch) {
+        QList<ServiceRegistration<QObject,ServiceScope::UNKNOWN>> result;
+        if(!batch.isValid()) {
+            qCCritical(loggingCategory()).noquote().nospace() << "Cannot register batch of " << batch.size() << " services. Invalid service-template";
+            return result;
+        }
+        for(auto handle : registerServiceHandles(batch.declarations())) {
+            result.push_back(ServiceRegistration<QObject,ServiceScope::UNKNOWN>::wrap(handle));
+        }
+        return result;
+    }
+
 
 
 
@@ -3986,12 +4212,12 @@ public:
     /// with the supplied name has been registered, this function will log an error and return an invalid ServiceRegistration.
     /// <br>The returned ServiceRegistration may be narrowed to a more specific service-type using ServiceRegistration::as().
     /// <br>**Thread-safety:** This function may be called safely  from any thread.
-    /// \param name the desired name of the registration.
+    /// \param name the desired name of the registration. May be supplied as a literal, a QString or any other String-view.
     /// A valid ServiceRegistration will be returned only if exactly one Service that matches the requested name has been registered.
     /// \return a ServiceRegistration for the required type and name. If no single Service with a matching name could be found,
     /// an invalid ServiceRegistration will be returned.
     ///
-    [[nodiscard]] ServiceRegistration<QObject,ServiceScope::UNKNOWN> getRegistration(const QString& name) const {
+    [[nodiscard]] ServiceRegistration<QObject,ServiceScope::UNKNOWN> getRegistration(QAnyStringView name) const {
         return ServiceRegistration<QObject,ServiceScope::UNKNOWN>::wrap(getRegistrationHandle(name));
     }
 
@@ -4081,7 +4307,8 @@ public:
     /// \brief Obtains configuration-keys available in this ApplicationContext.
     /// <br>The keys will be returned in the same order that the underlying QSettings yield them.
     /// <br>Keys that are present in more than one QSettings will be returned only once.
-    /// <br>In contrast to getConfigurationValue(const QString&, bool), this function does not consider environment variables.
+    /// <br>In contrast to getConfigurationValue(const QString&, bool), this function does not consider environment variables, unless an implementation
+    /// states otherwise.
     /// \param section determines which keys will be returned. An empty string denotes the "root".
     /// Sub-sections shall be delimited by forward slashes, in analogy to QSettings.
     /// \return a list with the keys that are present in the supplied section. The return keys will **comprise the supplied section**.
@@ -4215,6 +4442,16 @@ protected:
     ///
     virtual service_registration_handle_t registerServiceHandle(const QString& name, const service_descriptor& descriptor, const service_config& config, ServiceScope scope, const Condition& condition, QObject* baseObject) = 0;
 
+    ///
+    /// \brief Registers several services with this QApplicationContext.
+    /// <br>The default implementation invokes registerServiceHandle(const QString&, const service_descriptor&, const service_config&, ServiceScope, const Condition&, QObject*)
+    /// for each declaration. If one of the services cannot be registered, the services registered before will remain registered.
+    /// <br>Implementations should override this function in order to register the services atomically.
+    /// \param declarations the services to be registered.
+    /// \return the Registrations in the order of the declarations, or an empty QList if any of the services could not be registered.
+    ///
+    virtual QList<service_registration_handle_t> registerServiceHandles(const std::vector<detail::service_declaration>& declarations);
+
 
     ///
     /// \brief Obtains a Registration for a service_type.
@@ -4237,7 +4474,7 @@ protected:
     /// the name.
     /// \return a handle to a Registration for the supplied name, or `nullptr` if no single Service has been registered with the name.
     ///
-    [[nodiscard]] virtual service_registration_handle_t getRegistrationHandle(const QString& name) const = 0;
+    [[nodiscard]] virtual service_registration_handle_t getRegistrationHandle(QAnyStringView name) const = 0;
 
 
     /**
@@ -4272,6 +4509,21 @@ protected:
         return appContext->registerServiceHandle(name, descriptor, config, scope, condition, baseObj);
     }
 
+    ///
+    /// \brief Allows you to invoke a protected virtual function on another target.
+    /// <br>If you are implementing registerServiceHandles(const std::vector<detail::service_declaration>&) and want to delegate
+    /// to another implementation, access-rules will not allow you to invoke the function on another target.
+    /// \param appContext the target on which to invoke registerServiceHandles(const std::vector<detail::service_declaration>&).
+    /// \param declarations the services to be registered.
+    /// \return the result of registerServiceHandles(const std::vector<detail::service_declaration>&).
+    ///
+    static QList<service_registration_handle_t> delegateRegisterServices(QApplicationContext* appContext, const std::vector<detail::service_declaration>& declarations) {
+        if(!appContext) {
+            return {};
+        }
+        return appContext->registerServiceHandles(declarations);
+    }
+
 
     ///
     /// \brief Allows you to invoke a protected virtual function on another target.
@@ -4291,13 +4543,13 @@ protected:
 
     ///
     /// \brief Allows you to invoke a protected virtual function on another target.
-    /// <br>If you are implementing getRegistrationHandle(const QString&) const and want to delegate
+    /// <br>If you are implementing getRegistrationHandle(QAnyStringView) const and want to delegate
     /// to another implementation, access-rules will not allow you to invoke the function on another target.
-    /// \param appContext the target on which to invoke getRegistrationHandle(const QString&) const.
+    /// \param appContext the target on which to invoke getRegistrationHandle(QAnyStringView) const.
     /// \param name the name under which the service is looked up.
     /// \return the result of getRegistrationHandle(const std::type_info&,const QMetaObject*) const.
     ///
-    [[nodiscard]] static service_registration_handle_t delegateGetRegistrationHandle(const QApplicationContext* appContext, const QString& name) {
+    [[nodiscard]] static service_registration_handle_t delegateGetRegistrationHandle(const QApplicationContext* appContext, QAnyStringView name) {
         if(!appContext) {
             return nullptr;
         }
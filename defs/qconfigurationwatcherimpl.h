@@ -9,15 +9,17 @@ class QConfigurationWatcherImpl : public QConfigurationWatcher {
 public:
     QVariant currentValue() const override;
 
-    QConfigurationWatcherImpl(PlaceholderResolver* resolver, const QString& group, QVariantMap& additionalProperties, QApplicationContext* parent);
+    QConfigurationWatcherImpl(const PlaceholderResolver* resolver, const QString& group, QVariantMap& additionalProperties, const QVariantMap& privatePlaceholders, QApplicationContext* parent);
 
     void checkChange();
 
 private:
-    PlaceholderResolver* const m_resolver;
+    const PlaceholderResolver* const m_resolver;
     QApplicationContext* m_context;
     QString m_group;
     QVariantMap& m_additionalProperties;
+    // The private placeholders of the service, with their unresolved expressions.
+    const QVariantMap m_privatePlaceholders;
     QVariant m_lastValue;
 };
 }
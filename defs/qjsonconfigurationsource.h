@@ -0,0 +1,69 @@
+#pragma once
+#include "qapplicationcontext.h"
+#include <QJsonObject>
+#include <QDateTime>
+#include <QReadWriteLock>
+#include <QFileInfo>
+
+namespace mcnepp::qtdi {
+
+///
+/// \brief A QConfigurationSource that reads configuration-entries from a JSON-file.
+/// <br>The file must contain a JSON-object. Nested objects will be mapped to sections, i.e. the key of an entry will be
+/// the path to it with the names of all enclosing objects delimited by forward slashes:
+///
+///     { "timeout": 30, "network": { "host": "localhost", "port": 8080 } }
+///
+/// The above file yields the keys `"timeout"`, `"network/host"` and `"network/port"`. Arrays will be mapped to a single entry with a QVariantList as its value.
+/// <br>The file will be parsed once into a flat index. Values will only be converted into QVariants when they are requested.
+/// <br>Example:
+///
+///     context->registerObject(new QJsonConfigurationSource{"application.json", context});
+///
+class QJsonConfigurationSource : public QConfigurationSource {
+    Q_OBJECT
+public:
+    ///
+    /// \brief Creates a QJsonConfigurationSource and parses the file.
+    /// <br>If the file does not exist or cannot be parsed, the source will be empty.
+    /// \param fileName the name of the JSON-file.
+    /// \param parent the parent of this source.
+    ///
+    explicit QJsonConfigurationSource(const QString& fileName, QObject* parent = nullptr);
+
+    QVariant value(const QString& key) const override;
+
+    QStringList allKeys() const override;
+
+    QString fileName() const override;
+
+    bool hasFile() const override;
+
+    ///
+    /// \brief Parses the file again, if it has been modified.
+    ///
+    void refresh() override;
+
+    ///
+    /// \brief Creates a source for profile-specific configuration-entries.
+    /// \return a QJsonConfigurationSource for the file with the same base-name with a dash and the name of the profile appended, followed by the original suffix.
+    ///
+    QConfigurationSource* createForProfile(const QString& profile, QObject* parent) const override;
+
+private:
+    void load();
+
+    // Records the modification-time and size of the file, so that refresh() will not load it again before it has been modified.
+    void markLoaded(const QFileInfo& info);
+
+    static void index(const QJsonObject& object, const QString& prefix, QHash<QString,QJsonValue>& entries, QStringList& keys);
+
+    const QString m_fileName;
+    mutable QReadWriteLock m_lock;
+    QHash<QString,QJsonValue> m_entries;
+    QStringList m_keys;
+    QDateTime m_lastModified;
+    qint64 m_size = -1;
+};
+
+}
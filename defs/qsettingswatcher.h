@@ -1,10 +1,11 @@
 #pragma once
 #include "qapplicationcontext.h"
 #include "placeholderresolver.h"
-#include <QSettings>
 #include <QTimer>
 #include <QFileSystemWatcher>
+#include <QSet>
 #include <deque>
+#include <vector>
 
 namespace mcnepp::qtdi::detail {
 
@@ -17,34 +18,57 @@ class QSettingsWatcher : public QObject {
 Q_SIGNALS:
     void autoRefreshMillisChanged(int);
 
+    // Emitted after the QConfigurationSources have been refreshed, before the watched values are checked.
+    // Will only be emitted if at least one configuration-entry or environment-variable has changed.
+    // changedKeys contains the keys of all entries that have been modified, added or removed.
+    // environment contains all environment-variables, keyed by the configuration-key they correspond to (i.e. with dots replaced by slashes).
+    void settingsRefreshed(const QSet<QString>& changedKeys, const QHash<QString,QString>& environment);
+
 public:
     static constexpr int DEFAULT_REFRESH_MILLIS = 5000;
 
-    explicit QSettingsWatcher(QApplicationContext* parent);
+    QSettingsWatcher(QApplicationContext* parent, ResolverCache& resolverCache);
 
 
-    void addWatchedProperty(PlaceholderResolver* resolver, q_variant_converter_t variantConverter, const property_descriptor& propertyDescriptor, QObject* target, const QString& group, QVariantMap& resolvedProperties);
+    void addWatchedProperty(const PlaceholderResolver* resolver, q_variant_converter_t variantConverter, const property_descriptor& propertyDescriptor, QObject* target, const QString& group, QVariantMap& resolvedProperties, const QVariantMap& privatePlaceholders);
 
-    QConfigurationWatcher* watchConfigValue(PlaceholderResolver* resolver);
+    QConfigurationWatcher* watchConfigValue(const PlaceholderResolver* resolver);
 
     int autoRefreshMillis() const;
 
     void setAutoRefreshMillis(int newRefreshMillis);
 
-    void add(QSettings* settings);
+    void add(QConfigurationSource* source);
 private:
 
-    void handleRemovedFile(QSettings*);
-    void refreshFromSettings(QSettings* settings);
+    void handleRemovedFile(QConfigurationSource*);
+    void refreshFromSettings(QConfigurationSource* source);
+
+    // Compares the entries of the source with those of the previous refresh. Collects all keys that have changed.
+    void collectChanges(QConfigurationSource* source, QSet<QString>& changedKeys);
+
+    // Reads the environment and compares it with that of the previous refresh. Collects the keys of all variables that have changed.
+    void collectEnvironmentChanges(QSet<QString>& changedKeys);
+
+    // Appends the watcher to m_watched and records the names of all keys it depends on in m_dependentWatchers.
+    // This includes the keys that are referenced by the expressions of private placeholders.
+    void addWatcher(QConfigurationWatcher* watcher, const PlaceholderResolver* resolver, const QString& group, const QVariantMap& privatePlaceholders);
 
     void setPropertyValue(const property_descriptor &property, QObject *target, const QVariant& value);
 
     QApplicationContext* const m_context;
-    std::deque<QPointer<QSettings>> m_Settings;
+    ResolverCache& m_resolverCache;
+    std::deque<QPointer<QConfigurationSource>> m_Settings;
     QTimer* const m_SettingsWatchTimer;
     QFileSystemWatcher* const m_SettingsFileWatcher;
     std::deque<QPointer<QConfigurationWatcher>> m_watched;
     std::unordered_map<QString,QPointer<QConfigurationWatcher>> m_watchedConfigValues;
+    // The entries of each source as of the previous refresh.
+    std::unordered_map<QConfigurationSource*,QHash<QString,QVariant>> m_lastValues;
+    // Maps the last section of a configuration-key to the indices of all watchers in m_watched that may depend on it.
+    QHash<QString,std::vector<std::size_t>> m_dependentWatchers;
+    // The environment as of the previous refresh, keyed by the configuration-key that each variable corresponds to.
+    QHash<QString,QString> m_lastEnvironment;
     QVariantMap m_resolvedProperties;
 };
 
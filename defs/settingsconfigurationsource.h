@@ -0,0 +1,36 @@
+#pragma once
+#include "qapplicationcontext.h"
+#include <QSettings>
+
+namespace mcnepp::qtdi::detail {
+
+///
+/// \brief Makes a QSettings available as a QConfigurationSource.
+/// <br>For every QSettings that is registered with a StandardApplicationContext, an instance will be created and owned by the context.
+///
+class SettingsConfigurationSource : public QConfigurationSource {
+    Q_OBJECT
+public:
+    SettingsConfigurationSource(QSettings* settings, QObject* parent);
+
+    QVariant value(const QString& key) const override;
+
+    QStringList allKeys() const override;
+
+    QString fileName() const override;
+
+    bool hasFile() const override;
+
+    void refresh() override;
+
+    QConfigurationSource* createForProfile(const QString& profile, QObject* parent) const override;
+
+    QSettings* settings() const {
+        return m_settings;
+    }
+
+private:
+    QSettings* const m_settings;
+};
+
+}
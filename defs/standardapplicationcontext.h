@@ -4,18 +4,25 @@
 #include <unordered_map>
 #include <deque>
 #include <typeindex>
+#include <memory>
+#include <array>
+#include <atomic>
 #include <QMetaProperty>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QReadWriteLock>
 #include <QBindable>
 #include <QSettings>
+#include <QSet>
 #include "qapplicationcontext.h"
 #include "placeholderresolver.h"
+#include "atomtable.h"
 
 namespace mcnepp::qtdi {
 
 namespace detail {
     class QSettingsWatcher;
+    class SettingsConfigurationSource;
 }
 
 
@@ -43,6 +50,8 @@ class StandardApplicationContext final : public QApplicationContext
 
     class DescriptorRegistration;
 
+    class ProxyRegistrationImpl;
+
     class ServiceGroupRegistration;
 
     friend QApplicationContext* newDelegate(const QLoggingCategory& loggingCategory, QApplicationContext* delegatingContext);
@@ -129,8 +138,60 @@ public:
     ///
     bool autoRefreshEnabled() const override;
 
+    ///
+    /// \brief Re-reads the configuration-snapshot from all registered QSettings and from the environment.
+    /// <br>Once the configuration-snapshot has been enabled by setConfigurationSnapshotEnabled(bool), getConfigurationValue() will consult
+    /// an immutable, merged copy of all configuration-entries instead of querying each QSettings-object.
+    /// <br>The snapshot also contains a copy of the environment. Thus, changes to the environment will only become visible after invoking this function.
+    /// Environment-variables whose names contain a dot will be returned by configurationKeys(), as they denote entries within a section.
+    /// <br>While the configuration-snapshot is enabled, configurationKeys() will return the keys in lexicographical order.
+    /// <br>The snapshot will be re-read automatically whenever a QSettings-object is registered or the active profiles change.
+    /// If auto-refresh detects modified entries, only those will be looked up again. If you modify a QSettings-object directly, you need to invoke this function in order to make the modification visible.
+    /// <br>If the configuration-snapshot has not been enabled, this function has no effect other than re-evaluating Conditions.
+    /// <br>**Thread-safety:** This function may only be called from the ApplicationContext's thread.
+    ///
+    void refreshConfiguration();
+
+    ///
+    /// \brief Has the configuration-snapshot been enabled?
+    /// \return `true` if setConfigurationSnapshotEnabled(bool) has been invoked with `true`.
+    /// \sa refreshConfiguration()
+    ///
+    bool configurationSnapshotEnabled() const;
+
+    ///
+    /// \brief Enables or disables the configuration-snapshot.
+    /// <br>Enabling the snapshot will build it immediately from all registered QSettings and from the environment.
+    /// Disabling it will make getConfigurationValue() query each QSettings-object and the environment again upon each lookup.
+    /// <br>**Thread-safety:** This function may only be called from the ApplicationContext's thread.
+    /// \param enabled whether the configuration-snapshot shall be used.
+    /// \sa refreshConfiguration()
+    ///
+    void setConfigurationSnapshotEnabled(bool enabled);
+
     virtual Profiles activeProfiles() const override;
 
+    ///
+    /// \brief Freezes the registry of this ApplicationContext.
+    /// <br>Afterwards, no more services can be registered, and no more aliases can be added.
+    /// In return, looking up Registrations by name or by service-type will no longer lock a mutex. Instead,
+    /// an immutable snapshot of the lookup-tables will be consulted, making the lookup cheap even if it is performed frequently by many threads.
+    /// <br>Freezing does not affect publication: services that are still pending may be published afterwards.
+    /// <br>The Conditions of the Registrations will be evaluated in the ApplicationContext's thread when the snapshot is built. They will be
+    /// evaluated again whenever the active profiles change, refreshConfiguration() is invoked or pending services are published.
+    /// Lookups by name from any thread will yield the Registration that was active at that time.
+    /// <br>**Thread-safety:** This function may only be called from the ApplicationContext's thread.
+    /// \return `true` if the registry has been frozen (or had been frozen already).
+    ///
+    bool freeze();
+
+    ///
+    /// \brief Has the registry of this ApplicationContext been frozen?
+    /// \return `true` if freeze() has been invoked successfully.
+    /// \sa freeze()
+    ///
+    bool isFrozen() const;
+
     virtual QConfigurationWatcher* watchConfigValue(const QString& expression) override;
 
     virtual QVariant resolveConfigValue(const QString& expression, const QString& group, QVariantMap& resolvedPlaceholders) override;
@@ -146,7 +207,9 @@ protected:
 
     virtual service_registration_handle_t registerServiceHandle(const QString& name, const service_descriptor& descriptor, const service_config& config, ServiceScope scope, const Condition& condition, QObject* baseObj) override;
 
-    virtual service_registration_handle_t getRegistrationHandle(const QString& name) const override;
+    virtual QList<service_registration_handle_t> registerServiceHandles(const std::vector<detail::service_declaration>& declarations) override;
+
+    virtual service_registration_handle_t getRegistrationHandle(QAnyStringView name) const override;
 
     virtual proxy_registration_handle_t getRegistrationHandle(const std::type_info& service_type, const QMetaObject* metaObject) const override;
 
@@ -163,10 +226,154 @@ private:
 
     using descriptor_list = std::deque<DescriptorRegistration*>;
 
+    using proxy_list = std::vector<std::pair<ProxyRegistrationImpl*,DescriptorRegistration*>>;
+
+    // Performs the registration while the mutex is being held. Yields either a new or an identical existing registration, or nullptr.
+    // A new registration will be appended to registered. The cached proxies that it shall be added to will be appended to matchingProxies.
+    DescriptorRegistration* registerLocked(const QString& name, const service_descriptor& descriptor, const service_config& config, ServiceScope scope, const Condition& condition, QObject* baseObj, descriptor_list& registered, proxy_list& matchingProxies);
+
+    // Reverts a new registration made by registerLocked() and deletes it. Must be invoked while the mutex is still being held.
+    void unregisterLocked(DescriptorRegistration* reg);
+
+    // An immutable snapshot of the lookup-tables, which will be consulted without locking once the ApplicationContext has been frozen.
+    struct FrozenRegistry {
+        // For each name, the registration that was active when the snapshot was built. nullptr if there was none, or more than one.
+        std::unordered_map<detail::atom_t,DescriptorRegistration*> activeByName;
+        std::vector<DescriptorRegistration*> registrations;
+        // The registrations that were active when the snapshot was built.
+        std::vector<DescriptorRegistration*> activeRegistrations;
+        QList<service_registration_handle_t> handles;
+        // The registrations that were removed while this snapshot was the current one. They will be deleted together with the snapshot.
+        std::vector<std::unique_ptr<DescriptorRegistration>> retired;
+    };
+
+    // Registers the current thread as a reader of the frozen registry while in scope.
+    class FrozenRegistryReader;
+
+    // Builds a new snapshot from the current lookup-tables, evaluating the Conditions, and makes it the current one.
+    // The retired registration, if any, will be deleted together with the superseded snapshot. Must be invoked while the mutex is being held.
+    void refreeze(DescriptorRegistration* retired = nullptr) const;
+
+    // Deletes the superseded snapshots if no thread is consulting a snapshot anymore. May be invoked from any thread.
+    void reclaimFrozenRegistries() const;
+
+    // Selects the one candidate that is active in the current profiles. Yields nullptr if there is none, or if there is more than one.
+    template<typename C> DescriptorRegistration* selectActiveRegistration(detail::atom_t name, const C& candidates) const;
+
+    // An entry of the lock-free index of proxyRegistrationCache.
+    struct ProxyIndexEntry {
+        std::type_index type;
+        ProxyRegistrationImpl* proxy;
+        const ProxyIndexEntry* next;
+    };
+
+    static constexpr std::size_t PROXY_INDEX_BUCKETS = 64;
+
+    // An immutable, merged copy of all configuration-entries. Profile-specific QSettings take precedence over the others.
+    struct ConfigurationSnapshot {
+        unsigned version;
+        QHash<QString,QVariant> values;
+        // The environment-variables, keyed by the configuration-key they correspond to (i.e. with dots replaced by slashes).
+        QHash<QString,QString> environment;
+        // The keys of values plus the keys of environment that denote an entry within a section, sorted and without duplicates.
+        // The keys of a section form a contiguous range, starting at the lower bound of the section's prefix.
+        std::vector<QString> sortedKeys;
+
+        // Would configurationKeys() return the key?
+        bool containsKey(const QString& key) const {
+            return values.contains(key) || (key.contains('/') && environment.contains(key));
+        }
+
+        // Looks up the key and, if not found, the same key in each parent-section. Uses fallbacksByName, thus it needs no locking
+        // and creates no intermediate keys.
+        QVariant findInParentSections(const QString& key) const;
+
+        // Builds fallbacksByName from values. Must be invoked before the snapshot is published.
+        void buildFallbacks();
+
+        // Replaces the entry for the key in fallbacksByName. An invalid value removes the entry. Must be invoked before the snapshot is published.
+        void updateFallback(const QString& key, const QVariant& value);
+
+        // An entry that may be found by findInParentSections().
+        struct fallback {
+            // The part of the key before the last slash. Empty if isTopLevel.
+            QString section;
+            // Does the key contain no slash at all?
+            bool isTopLevel;
+            QVariant value;
+        };
+
+        // For each name (i.e. the part of a key after the last slash): all entries with that name, the most deeply nested first.
+        QHash<QString,std::vector<fallback>> fallbacksByName;
+
+        static void sortFallbacks(std::vector<fallback>& candidates);
+    };
+
+    // Yields the current configuration-snapshot, or nullptr if it has not been enabled. May be invoked from any thread.
+    std::shared_ptr<const ConfigurationSnapshot> configurationSnapshot() const;
+
+    // Invoked by auto-refresh if configuration-entries have changed. Derives a new snapshot from the current one by looking up only the changed keys.
+    // Re-evaluates the Conditions, like refreshConfiguration().
+    void updateConfigurationSnapshot(const QSet<QString>& changedKeys, const QHash<QString,QString>& environment);
+
+    // Publishes the snapshot and discards the memoized results that have not been validated against the previous snapshot.
+    void publishConfigurationSnapshot(std::shared_ptr<const ConfigurationSnapshot> snapshot, const ConfigurationSnapshot* previous);
+
+    // Looks up a configuration-value in the snapshot, consulting the environment first.
+    QVariant getConfigurationValue(const ConfigurationSnapshot& snapshot, const QString& key, bool searchParentSections) const;
+
+    // Looks up a configuration-value in the environment and then in the supplied sources.
+    QVariant getConfigurationValue(const QList<QConfigurationSource*>& sources, const QString& key, bool searchParentSections) const;
+
+    // Looks up the values of all keys of the batch in one pass.
+    void fetchConfigurationValues(detail::placeholder_batch& batch) const;
+
+    // Looks up the values of all keys of the batch in the snapshot.
+    void fetchConfigurationValues(const ConfigurationSnapshot& snapshot, detail::placeholder_batch& batch) const;
+
+    // The memoized result of a PlaceholderResolver for a resolved group.
+    struct memoized_result {
+        // The version of the configuration-snapshot that the result has last been validated against.
+        unsigned version;
+        // The configuration-values that were read.
+        detail::placeholder_batch batch;
+        QVariant result;
+    };
+
+    static constexpr std::size_t MEMO_SHARD_COUNT = 16;
+
+    // The memoized results are distributed across shards by their key, so that threads resolving different expressions do not contend.
+    // When the snapshot is rebuilt, results that have not been validated against the previous snapshot will be discarded.
+    struct memo_shard {
+        QReadWriteLock lock;
+        // Keyed by the expression and the resolved group.
+        QHash<std::pair<QString,QString>,memoized_result> results;
+    };
+
+    // Resolves the expression like detail::PlaceholderResolver::resolve(const QString&, QVariantMap&) const.
+    // If the configuration-snapshot has been enabled, the result will be memoized, provided that all placeholders have been found in the snapshot.
+    // Such a result does not depend on the resolvedPlaceholders. It will be re-used until one of the configuration-values it has read changes.
+    // May be invoked from any thread.
+    QVariant resolveMemoized(const detail::PlaceholderResolver* resolver, const QString& group, QVariantMap& resolvedPlaceholders);
+
+    // Looks up the memoized result of the resolver for the resolved group. A result that has been validated against an older snapshot
+    // will be re-validated outside of the lock. If a valid result has been found, its placeholders will be stored into resolvedPlaceholders.
+    bool findMemoized(const detail::PlaceholderResolver* resolver, const QString& resolvedGroup, const ConfigurationSnapshot& snapshot, QVariantMap& resolvedPlaceholders, QVariant& result);
+
+    // Memoizes the result that the resolver has obtained from the batch, provided that the batch contains values for all of its placeholders.
+    void memoize(const detail::PlaceholderResolver* resolver, const ConfigurationSnapshot& snapshot, const detail::placeholder_batch& batch, const QVariant& result);
+
+    // The most recent conversion of a value that has been resolved from a placeholder-expression.
+    struct conversion {
+        QString input;
+        QVariant converted;
+    };
 
 
     static constexpr int STATE_INIT = 0;
     static constexpr int STATE_NEEDS_CONFIGURATION = 1;
+    //The state of a lazy Service whose dependencies have been resolved, but which has not been created yet:
+    static constexpr int STATE_PLANNED = 2;
     static constexpr int STATE_PUBLISHED = 3;
     //The state reported by a Service-Template
     static constexpr int STATE_IGNORE = 4;
@@ -254,6 +461,17 @@ private:
             return info.isValid() && matches(info.type) && (!info.has_required_name() || info.expression == registeredName());
         }
 
+        // Collects all types this registration can be found by: the service-types and impl-type of its descriptor
+        // and of its chain of base-registrations. (QObject is not included, as every registration matches it.)
+        std::unordered_set<std::type_index> indexedTypes() const {
+            std::unordered_set<std::type_index> types;
+            for(auto self = this; self; self = self->m_base) {
+                types.insert(self->descriptor().impl_type);
+                types.insert(self->descriptor().service_types.begin(), self->descriptor().service_types.end());
+            }
+            return types;
+        }
+
 
         unsigned index() const {
             return m_index;
@@ -261,11 +479,6 @@ private:
 
 
 
-        static auto matcher(const dependency_info& info) {
-            return [&info](DescriptorRegistration* reg) { return reg->matches(info); };
-        }
-
-
         DescriptorRegistration(DescriptorRegistration* base, unsigned index, const QString& name, const service_descriptor& desc, const service_config& config, StandardApplicationContext* context, QObject* parent);
 
         DescriptorRegistration(DescriptorRegistration* base, unsigned index, const QString& name, const service_descriptor& desc, const service_config& config, StandardApplicationContext* parent) :
@@ -282,6 +495,11 @@ private:
 
         virtual int unpublish() = 0;
 
+        // May the service be created in another thread than the ApplicationContext's?
+        virtual bool canBeCreatedConcurrently() const {
+            return false;
+        }
+
         QVariantMap& resolvedPlaceholders() {
             return m_resolvedPlaceholders;
         }
@@ -290,6 +508,8 @@ private:
             return m_base;
         }
 
+        // Does the Condition match? The result is cached until the ApplicationContext invalidates all Conditions.
+        // A Condition that depends on configuration-values will only be cached while the configuration-snapshot is enabled.
         bool isActiveInProfile() const;
 
     protected:
@@ -302,6 +522,16 @@ private:
         Condition m_condition;
         QVariantMap m_resolvedPlaceholders;
         service_config m_config;
+        // The most recent conversion per property and per dependency. Will only be accessed in the ApplicationContext's thread.
+        QHash<QString,conversion> m_propertyConversions;
+        std::unordered_map<const dependency_info*,conversion> m_dependencyConversions;
+        // The edges of the dependency-graph: the registrations this one depends on, and the registrations that depend on this one.
+        descriptor_set m_dependsOn;
+        descriptor_set m_dependents;
+        // The position in the topological order of the dependency-graph. 0 means: not part of the graph.
+        unsigned m_order = 0;
+        // The last result of isActiveInProfile() in the lowest bit, the conditionGeneration it was computed for in the upper bits.
+        mutable std::atomic<std::uint64_t> m_conditionCache = 0;
     };
 
 
@@ -323,7 +553,7 @@ private:
         }
 
         virtual bool provideConfig() const override {
-            return m_descriptor.impl_type == typeid(QSettings);
+            return m_descriptor.impl_type == typeid(QSettings) || (m_descriptor.meta_object && m_descriptor.meta_object->inherits(&QConfigurationSource::staticMetaObject));
         }
 
 
@@ -343,9 +573,8 @@ private:
             return theService;
         }
 
-        virtual QObjectList obtainServices(descriptor_list&) override {
-            return theService ? QObjectList{theService} : QObjectList{};
-        }
+        // If the Service is lazy and has not been created yet, it will be created now and appended to created.
+        virtual QObjectList obtainServices(descriptor_list& created) override;
 
 
 
@@ -356,17 +585,19 @@ private:
 
 
 
+        // If the Service is lazy, will store the dependencies for deferred creation.
         virtual bool prepareService(const QVariantList& dependencies, descriptor_list& created) override;
 
+        // Shall the Service be created on demand only?
+        bool isLazy() const;
+
+        // Takes ownership of the newly created service. The Registrations in createdForThis will become its children and will be appended to created.
+        void adoptService(QObject* service, const descriptor_list& createdForThis, descriptor_list& created);
+
+        virtual bool canBeCreatedConcurrently() const override;
 
-        virtual void onSubscription(subscription_handle_t subscription) override {
-            //If the Service is already present, there is no need to connect to the signal:
-            if(isPublished()) {
-                emit subscription->objectPublished(theService);
-            } else {
-                subscription->connectTo(this);
-            }
-        }
+
+        virtual void onSubscription(subscription_handle_t subscription) override;
 
 
 
@@ -382,6 +613,7 @@ private:
         QObject* theService;
         QMetaObject::Connection onDestroyed;
         int m_state;
+        QVariantList m_dependencies;
     };
 
 
@@ -512,10 +744,14 @@ private:
             theObj(obj){
             //Do not connect the signal QObject::destroyed if obj is the ApplicationContext itself:
             if(obj != parent->m_injectedContext) {
-                connect(obj, &QObject::destroyed, parent, [this] { m_context->contextObjectDestroyed(this);});
+                onDestroyed = connect(obj, &QObject::destroyed, parent, [this] { m_context->contextObjectDestroyed(this);});
             }
         }
 
+        ~ObjectRegistration() {
+            QObject::disconnect(onDestroyed);
+        }
+
         void notifyPublished() override {
         }
 
@@ -562,6 +798,7 @@ private:
 
     private:
         QObject* const theObj;
+        QMetaObject::Connection onDestroyed;
     };
 
 
@@ -572,7 +809,7 @@ private:
 
         friend class StandardApplicationContext;
 
-        ProxyRegistrationImpl(const std::type_info& type, const QMetaObject* metaObject, StandardApplicationContext* parent);
+        ProxyRegistrationImpl(const std::type_info& type, const QMetaObject* metaObject, StandardApplicationContext* context, QObject* parent);
 
 
         bool matches(const std::type_info& type) const override {
@@ -598,6 +835,9 @@ private:
 
         bool canAdd(DescriptorRegistration* reg) const;
 
+        // Subscribes to all matching registrations. Must be invoked in the ApplicationContext's thread, without holding the mutex.
+        void subscribeMatching();
+
         virtual void onSubscription(subscription_handle_t subscription) override;
 
 
@@ -617,6 +857,8 @@ private:
         const QMetaObject* m_meta;
         ProxySubscription* proxySubscription;
         StandardApplicationContext* const m_context;
+        // Will only be accessed in the ApplicationContext's thread.
+        bool m_subscribed = false;
     };
 
 
@@ -630,21 +872,56 @@ private:
         fatal
     };
 
+    // A service whose dependencies have been resolved in the ApplicationContext's thread,
+    // but whose constructor will be invoked in another thread:
+    struct ConcurrentCreation {
+        ServiceRegistrationImpl* registration;
+        QVariantList arguments;
+        descriptor_list createdForThis;
+        QObject* service = nullptr;
+    };
+
+    // Invokes the constructors concurrently and waits for them to finish.
+    // Afterwards, all created services will have been moved to the ApplicationContext's thread.
+    void createConcurrently(std::vector<ConcurrentCreation>& creations);
+
+
+    // Configures the Services in needConfiguration, then initializes and publishes them.
+    // The PostProcessors will be looked up among allCreated.
+    Status publishCreated(descriptor_list& needConfiguration, const descriptor_list& allCreated, bool allowPartial, qsizetype& publishedCount);
+
+    // Creates and publishes a lazy Service that has been demanded after publication.
+    void publishOnDemand(DescriptorRegistration* reg);
 
-    Status validate(bool allowPartial, const descriptor_list& published, descriptor_list& unpublished);
+    // Subscribes the proxies that have been created in other threads to their matching registrations.
+    // Must be invoked in the ApplicationContext's thread, without holding the mutex.
+    void subscribePendingProxies();
 
-    bool checkTransitiveDependentsOn(const service_descriptor& descriptor, const QString& name, const std::unordered_set<dependency_info>& dependencies) const;
+    Status validate(bool allowPartial, const descriptor_set& published, descriptor_list& unpublished);
 
-    bool findTransitiveDependenciesOf(const service_descriptor& descriptor, std::unordered_set<dependency_info>& dependents) const;
+    // Orders the registrations topologically (Kahn's algorithm), using the edges of the dependency-graph between them.
+    // For publication, dependencies precede their dependents. For un-publication, it is the other way round.
+    // Barring these restrictions, the order of registration is kept (or reversed, for un-publication).
+    static descriptor_list plan(const descriptor_list& regs, bool forUnpublication);
+
+    // Adds the registration to the dependency-graph, connecting it with the registrations it depends on and with those that depend on it.
+    // Returns false (leaving the graph unchanged) if that would introduce a cycle.
+    bool addToDependencyGraph(DescriptorRegistration* reg);
+
+    // Maintains the topological order after the edge from -> to has been added (Pearce-Kelly).
+    // Returns false if the edge closes a cycle.
+    bool reorderDependencyGraph(DescriptorRegistration* from, DescriptorRegistration* to);
 
     void unpublish();
 
     void contextObjectDestroyed(DescriptorRegistration*);
 
-    DescriptorRegistration* getActiveRegistrationByName(const QString& name) const;
+    DescriptorRegistration* getActiveRegistrationByName(QAnyStringView name) const;
+
+    DescriptorRegistration* getActiveRegistrationByName(detail::atom_t name) const;
 
 
-    std::pair<QVariant,Status> resolveDependency(const descriptor_list& published, DescriptorRegistration* reg, const dependency_info& d, bool allowPartial);
+    std::pair<QVariant,Status> resolveDependency(const descriptor_set& published, DescriptorRegistration* reg, const dependency_info& d, bool allowPartial);
 
     static QVariantList resolveDependencies(const QVariantList& dependencies, descriptor_list& created);
 
@@ -662,17 +939,45 @@ private:
 
     bool validateResolvers(const service_descriptor& descriptor, const service_config& config);
 
-    detail::PlaceholderResolver* getResolver(const QString&);
+    // Obtains the PlaceholderResolver from the resolverCache. May be invoked from any thread.
+    const detail::PlaceholderResolver* getResolver(const QString&);
+
+    // Applies the converter to a value that has been resolved from a placeholder-expression.
+    // If the converter has already converted the same string into the cache, the previous result will be returned.
+    // Pointers will not be cached, as every instance of a prototype shall receive its own converted value.
+    static QVariant convertResolved(conversion& cache, const detail::q_variant_converter_t& converter, const QVariant& resolved);
+
+    // Yields a converter that delegates to convertResolved() with a cache of its own, starting with the given conversion.
+    // Returns nullptr if the converter is nullptr.
+    static detail::q_variant_converter_t cachingConverter(const conversion& initial, const detail::q_variant_converter_t& converter);
 
     void onSettingsAdded(QSettings*);
 
+    void onConfigurationSourceAdded(QConfigurationSource*);
+
+    // The registered QConfigurationSources in the order of registration, optionally preceded by the profile-specific sources.
+    // Registered QSettings are represented by their detail::SettingsConfigurationSource.
+    QList<QConfigurationSource*> configurationSources(bool includeProfiles) const;
+
+    // Discards the cached results of all Conditions. Invoked whenever the active profiles or the configuration may have changed.
+    // If the ApplicationContext has been frozen, the snapshot will be rebuilt. Must not be invoked while the mutex is being held.
+    void invalidateConditions();
+
     QObject* obtainHandleFromApplicationThread(std::function<QObject*()>);
 
     void insertByName(const QString& name, DescriptorRegistration* reg);
 
-    bool canChangeActiveProfiles();
+    // Inserts the registration into registrationsByType, using all of its indexedTypes().
+    void insertByType(DescriptorRegistration* reg);
 
-    QSettings* settingsForProfile(QSettings* settings, const QString& profile);
+    // Inserts the registration into registrationsByMetaObject, using the QMetaObject of its service-object and all super-classes.
+    // Does nothing if the service-object has not been created yet.
+    void insertByMetaObject(DescriptorRegistration* reg);
+
+    // Yields all registrations that match the type, in the order of registration.
+    const descriptor_list& registrationsMatching(const std::type_info& type) const;
+
+    bool canChangeActiveProfiles();
 
     void initSettingsForActiveProfiles();
 
@@ -700,20 +1005,57 @@ private:
 
     descriptor_list registrations;
 
-    std::unordered_map<QString,std::unordered_set<DescriptorRegistration*>> registrationsByName;
+    // The names of all registrations and aliases. Will only be modified while the mutex is being held, and not at all once the ApplicationContext has been frozen.
+    detail::AtomTable nameAtoms;
+
+    std::unordered_map<detail::atom_t,std::unordered_set<DescriptorRegistration*>> registrationsByName;
+
+    std::unordered_map<std::type_index,descriptor_list> registrationsByType;
+
+    std::unordered_map<const QMetaObject*,descriptor_set> registrationsByMetaObject;
+
+    // For each dependency-type: the registrations that have a dependency of that type.
+    std::unordered_map<std::type_index,std::vector<std::pair<DescriptorRegistration*,const dependency_info*>>> dependentsByType;
+
+    unsigned nextOrder = 0;
 
     mutable std::unordered_map<std::type_index,ProxyRegistrationImpl*> proxyRegistrationCache;
+    // Proxies that have been created in other threads and have not been subscribed to their matching registrations yet. Guarded by the mutex.
+    mutable std::vector<ProxyRegistrationImpl*> pendingProxies;
+    mutable std::atomic<bool> hasPendingProxies = false;
+    // An append-only copy of proxyRegistrationCache that will be consulted without locking. Entries will only be added while the mutex is being held.
+    mutable std::array<std::atomic<const ProxyIndexEntry*>,PROXY_INDEX_BUCKETS> proxyIndex{};
     mutable QMutex mutex;
     mutable QWaitCondition m_condition;
-    std::unordered_map<registration_handle_t,std::unordered_set<QString>> m_boundProperties;
+    // The current snapshot, preceded by the superseded snapshots that may still be consulted by readers.
+    mutable std::vector<std::unique_ptr<FrozenRegistry>> frozenRegistries;
+    // Guards frozenRegistries. Will never be held while a snapshot is consulted, so that the last reader can reclaim the superseded snapshots.
+    mutable QMutex frozenRegistriesMutex;
+    mutable std::atomic<const FrozenRegistry*> frozenRegistry = nullptr;
+    // The number of threads that are currently consulting frozenRegistry.
+    mutable std::atomic<int> frozenRegistryReaders = 0;
+    mutable std::atomic<bool> hasSupersededRegistries = false;
+    // Incremented by invalidateConditions(). Starts at 1, so that no DescriptorRegistration has a valid cached result initially.
+    std::atomic<std::uint32_t> conditionGeneration = 1;
+    // Placeholder-expressions and bound property-names. Will only be accessed in the ApplicationContext's thread.
+    detail::AtomTable expressionAtoms;
+    std::unordered_map<registration_handle_t,std::unordered_set<detail::atom_t>> m_boundProperties;
     std::atomic<unsigned> nextIndex;
     const QLoggingCategory& m_loggingCategory;
     QApplicationContext* const m_injectedContext;
 
     detail::QSettingsWatcher* m_SettingsWatcher = nullptr;
-    std::unordered_map<QString,QPointer<detail::PlaceholderResolver>> resolverCache;
+    detail::ResolverCache resolverCache;
+    std::array<memo_shard,MEMO_SHARD_COUNT> memoizedResults;
     Profiles* m_activeProfiles;
-    std::unordered_map<ProfileAndName,QSettings*,ProfileNameHash> m_profileSettings;
+    std::unordered_map<ProfileAndName,QConfigurationSource*,ProfileNameHash> m_profileSettings;
+    // The sources that represent the registered QSettings. The sources are children of this ApplicationContext, as the QSettings may live in another thread.
+    // Guarded by m_settingsSourcesLock, as configurationSources() may be invoked from any thread.
+    std::unordered_map<QSettings*,detail::SettingsConfigurationSource*> m_settingsSources;
+    mutable QReadWriteLock m_settingsSourcesLock;
+    // Will only be accessed using std::atomic_load() and std::atomic_store().
+    std::shared_ptr<const ConfigurationSnapshot> m_configurationSnapshot;
+    std::atomic<bool> m_configurationSnapshotEnabled = false;
 };
 
 namespace detail {
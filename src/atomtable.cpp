@@ -0,0 +1,75 @@
+#include "atomtable.h"
+#include <algorithm>
+
+namespace mcnepp::qtdi::detail {
+
+namespace {
+
+constexpr std::size_t FNV_OFFSET_BASIS = sizeof(std::size_t) == 8 ? 14695981039346656037ULL : 2166136261U;
+constexpr std::size_t FNV_PRIME = sizeof(std::size_t) == 8 ? 1099511628211ULL : 16777619U;
+
+// Non-ASCII UTF-8 must be decoded before hashing, so that it yields the same hash as the equivalent UTF-16 String:
+bool needsDecoding(QAnyStringView str) {
+    if(!str.isUtf8()) {
+        return false;
+    }
+    auto data = static_cast<const unsigned char*>(str.data());
+    return std::any_of(data, data + str.size_bytes(), [](unsigned char ch) { return ch >= 0x80; });
+}
+
+char16_t codeUnit(QChar ch) {
+    return ch.unicode();
+}
+
+char16_t codeUnit(QLatin1Char ch) {
+    return ch.unicode();
+}
+
+char16_t codeUnit(char ch) {
+    return static_cast<unsigned char>(ch);
+}
+
+}
+
+std::size_t AtomTable::hash(QAnyStringView str)
+{
+    // FNV-1a over the UTF-16 code-units. Latin1 and ASCII are widened code-unit by code-unit:
+    return str.visit([](auto view) {
+        std::size_t h = FNV_OFFSET_BASIS;
+        for(auto ch : view) {
+            h = (h ^ codeUnit(ch)) * FNV_PRIME;
+        }
+        return h;
+    });
+}
+
+atom_t AtomTable::find(QAnyStringView str) const
+{
+    if(needsDecoding(str)) {
+        return find(str.toString());
+    }
+    auto range = m_atoms.equal_range(hash(str));
+    for(auto iter = range.first; iter != range.second; ++iter) {
+        if(QAnyStringView::equal(str, iter->second)) {
+            return &iter->second;
+        }
+    }
+    return nullptr;
+}
+
+atom_t AtomTable::intern(QAnyStringView str)
+{
+    if(needsDecoding(str)) {
+        return intern(str.toString());
+    }
+    std::size_t h = hash(str);
+    auto range = m_atoms.equal_range(h);
+    for(auto iter = range.first; iter != range.second; ++iter) {
+        if(QAnyStringView::equal(str, iter->second)) {
+            return &iter->second;
+        }
+    }
+    return &m_atoms.emplace(h, str.toString())->second;
+}
+
+}
@@ -0,0 +1,610 @@
+#include "compiledsettings.h"
+#include "qapplicationcontext.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDataStream>
+#include <QRect>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace mcnepp::qtdi {
+
+namespace {
+
+constexpr char IMAGE_MAGIC[8] = {'Q', 'T', 'D', 'I', 'C', 'F', 'G', '1'};
+
+constexpr QDataStream::Version IMAGE_STREAM_VERSION = QDataStream::Qt_6_0;
+
+// Layout of an image: header, index_entry[entryCount], UTF-16 key-table, value-blob.
+struct image_header {
+    char magic[8];
+    quint32 entryCount;
+    quint32 keyTableSize; // In UTF-16 code-units
+    qint64 sourceModified; // Milliseconds since epoch
+    qint64 sourceSize;
+};
+
+struct index_entry {
+    quint32 keyOffset; // In UTF-16 code-units, relative to the key-table
+    quint32 keyLength;
+    quint32 valueOffset; // In bytes, relative to the value-blob
+    quint32 valueLength;
+};
+
+// The sections of a mapped image that has been validated.
+struct image_layout {
+    const uchar* data;
+    quint32 entryCount;
+    qint64 keyTableStart;
+    qint64 valueBlobStart;
+
+    index_entry entry(quint32 index) const {
+        index_entry result;
+        std::memcpy(&result, data + sizeof(image_header) + index * sizeof(index_entry), sizeof result);
+        return result;
+    }
+
+    QStringView key(const index_entry& entry) const {
+        return QStringView{reinterpret_cast<const QChar*>(data + keyTableStart) + entry.keyOffset, qsizetype(entry.keyLength)};
+    }
+
+    QVariant value(const index_entry& entry) const {
+        QDataStream stream{QByteArray::fromRawData(reinterpret_cast<const char*>(data + valueBlobStart + entry.valueOffset), entry.valueLength)};
+        stream.setVersion(IMAGE_STREAM_VERSION);
+        QVariant value;
+        stream >> value;
+        return value;
+    }
+};
+
+QString imagePath(const QFileInfo& source) {
+    return source.filePath() + ".qtdicache";
+}
+
+// Maps the image of the source. The image stays mapped as long as the QFile exists.
+std::optional<image_layout> mapImage(const QFileInfo& source, QFile& file) {
+    if(!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    const qint64 size = file.size();
+    if(size < qint64(sizeof(image_header))) {
+        return std::nullopt;
+    }
+    const uchar* data = file.map(0, size);
+    if(!data) {
+        return std::nullopt;
+    }
+    image_header header;
+    std::memcpy(&header, data, sizeof header);
+    const qint64 keyTableStart = sizeof(image_header) + qint64(header.entryCount) * sizeof(index_entry);
+    const qint64 valueBlobStart = keyTableStart + qint64(header.keyTableSize) * sizeof(char16_t);
+    if(std::memcmp(header.magic, IMAGE_MAGIC, sizeof IMAGE_MAGIC) != 0 ||
+        header.sourceModified != source.lastModified().toMSecsSinceEpoch() ||
+        header.sourceSize != source.size() ||
+        valueBlobStart > size) {
+        // The image is outdated or corrupt:
+        return std::nullopt;
+    }
+    image_layout layout{data, header.entryCount, keyTableStart, valueBlobStart};
+    for(quint32 index = 0; index < header.entryCount; ++index) {
+        index_entry entry = layout.entry(index);
+        if(entry.keyOffset + qint64(entry.keyLength) > header.keyTableSize || valueBlobStart + entry.valueOffset + qint64(entry.valueLength) > size) {
+            return std::nullopt;
+        }
+    }
+    return layout;
+}
+
+bool readImage(const QFileInfo& source, QSettings::SettingsMap& map) {
+    QFile file{imagePath(source)};
+    auto layout = mapImage(source, file);
+    if(!layout) {
+        return false;
+    }
+    for(quint32 index = 0; index < layout->entryCount; ++index) {
+        index_entry entry = layout->entry(index);
+        map.insert(layout->key(entry).toString(), layout->value(entry));
+    }
+    return true;
+}
+
+void writeImage(const QFileInfo& source, const QSettings::SettingsMap& map) {
+    image_header header;
+    std::memcpy(header.magic, IMAGE_MAGIC, sizeof IMAGE_MAGIC);
+    header.entryCount = quint32(map.size());
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    header.sourceSize = source.size();
+
+    std::vector<index_entry> index;
+    index.reserve(map.size());
+    QString keyTable;
+    QByteArray valueBlob;
+    QDataStream stream{&valueBlob, QIODevice::WriteOnly};
+    stream.setVersion(IMAGE_STREAM_VERSION);
+    // QSettings::SettingsMap is a QMap, hence the keys are already sorted:
+    for(auto iter = map.cbegin(); iter != map.cend(); ++iter) {
+        index_entry entry;
+        entry.keyOffset = quint32(keyTable.size());
+        entry.keyLength = quint32(iter.key().size());
+        entry.valueOffset = quint32(valueBlob.size());
+        keyTable += iter.key();
+        stream << iter.value();
+        entry.valueLength = quint32(valueBlob.size()) - entry.valueOffset;
+        index.push_back(entry);
+    }
+    header.keyTableSize = quint32(keyTable.size());
+
+    QSaveFile file{imagePath(source)};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qCWarning(defaultLoggingCategory()).noquote().nospace() << "Could not write compiled configuration " << file.fileName() << ": " << file.errorString();
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+    file.write(reinterpret_cast<const char*>(index.data()), qint64(index.size() * sizeof(index_entry)));
+    file.write(reinterpret_cast<const char*>(keyTable.constData()), keyTable.size() * qint64(sizeof(char16_t)));
+    file.write(valueBlob);
+    // QSaveFile replaces the image atomically, so that processes which have mapped the previous image will not be affected:
+    if(!file.commit()) {
+        qCWarning(defaultLoggingCategory()).noquote().nospace() << "Could not write compiled configuration " << file.fileName() << ": " << file.errorString();
+        return;
+    }
+    qCInfo(defaultLoggingCategory()).noquote().nospace() << "Compiled configuration " << source.filePath() << " into " << file.fileName();
+}
+
+int hexValue(QChar ch) {
+    if(ch >= u'0' && ch <= u'9') {
+        return ch.unicode() - u'0';
+    }
+    if(ch >= u'a' && ch <= u'f') {
+        return ch.unicode() - u'a' + 10;
+    }
+    if(ch >= u'A' && ch <= u'F') {
+        return ch.unicode() - u'A' + 10;
+    }
+    return -1;
+}
+
+// Reverses the escaping of keys that QSettings::IniFormat applies: '\\' denotes a '/', "%XX" and "%UXXXX" denote code-points.
+QString unescapeKey(QStringView key) {
+    QString result;
+    result.reserve(key.size());
+    for(qsizetype index = 0; index < key.size(); ++index) {
+        QChar ch = key[index];
+        if(ch == u'\\') {
+            result += u'/';
+            continue;
+        }
+        if(ch == u'%') {
+            qsizetype digits = 2;
+            qsizetype start = index + 1;
+            if(start < key.size() && key[start] == u'U') {
+                digits = 4;
+                ++start;
+            }
+            char16_t code = 0;
+            qsizetype end = start;
+            for(; end < start + digits && end < key.size() && hexValue(key[end]) >= 0; ++end) {
+                code = code * 16 + hexValue(key[end]);
+            }
+            if(end == start + digits) {
+                result += QChar{code};
+                index = end - 1;
+                continue;
+            }
+        }
+        result += ch;
+    }
+    return result;
+}
+
+void chopTrailingSpaces(QString& str, qsizetype limit) {
+    qsizetype size = str.size();
+    while(size > limit && (str[size - 1] == u' ' || str[size - 1] == u'\t')) {
+        --size;
+    }
+    str.truncate(size);
+}
+
+// Splits the space-separated arguments of "@Rect(...)", "@Size(...)" and "@Point(...)". The opening parenthesis is at openingPos.
+QStringList splitArgs(const QString& str, qsizetype openingPos) {
+    return str.sliced(openingPos + 1).chopped(1).split(u' ');
+}
+
+// Converts a single value the way QSettings::IniFormat does: "@ByteArray(...)", "@String(...)", "@Variant(...)", "@Rect(...)", "@Size(...)",
+// "@Point(...)" and "@Invalid()" denote special types.
+QVariant stringToVariant(const QString& str) {
+    if(str.startsWith(u'@')) {
+        if(str.endsWith(u')')) {
+            if(str.startsWith("@ByteArray(")) {
+                return QStringView{str}.sliced(11).chopped(1).toLatin1();
+            }
+            if(str.startsWith("@String(")) {
+                return QStringView{str}.sliced(8).chopped(1).toString();
+            }
+            if(str.startsWith("@Variant(") || str.startsWith("@DateTime(")) {
+                bool isDateTime = str.at(1) == u'D';
+                QByteArray data = QStringView{str}.sliced(isDateTime ? 10 : 9).toLatin1();
+                QDataStream stream{data};
+                stream.setVersion(isDateTime ? QDataStream::Qt_5_6 : QDataStream::Qt_4_0);
+                QVariant result;
+                stream >> result;
+                return result;
+            }
+            if(str.startsWith("@Rect(")) {
+                if(QStringList args = splitArgs(str, 5); args.size() == 4) {
+                    return QRect{args[0].toInt(), args[1].toInt(), args[2].toInt(), args[3].toInt()};
+                }
+            } else if(str.startsWith("@Size(")) {
+                if(QStringList args = splitArgs(str, 5); args.size() == 2) {
+                    return QSize{args[0].toInt(), args[1].toInt()};
+                }
+            } else if(str.startsWith("@Point(")) {
+                if(QStringList args = splitArgs(str, 6); args.size() == 2) {
+                    return QPoint{args[0].toInt(), args[1].toInt()};
+                }
+            } else if(str == "@Invalid()") {
+                return QVariant{};
+            }
+        }
+        if(str.startsWith("@@")) {
+            return str.sliced(1);
+        }
+    }
+    return str;
+}
+
+// Parses the value of an entry. Unquoted commas separate the elements of a list.
+QVariant parseValue(QStringView str) {
+    static constexpr char16_t escapeCodes[][2] = {
+        {u'a', u'\a'}, {u'b', u'\b'}, {u'f', u'\f'}, {u'n', u'\n'}, {u'r', u'\r'}, {u't', u'\t'}, {u'v', u'\v'},
+        {u'"', u'"'}, {u'?', u'?'}, {u'\'', u'\''}, {u'\\', u'\\'}
+    };
+    QString current;
+    QStringList elements;
+    bool isList = false;
+    bool inQuotes = false;
+    bool currentIsQuoted = false;
+    qsizetype chopLimit = 0;
+    qsizetype index = 0;
+    auto skipSpaces = [&str,&index] {
+        while(index < str.size() && (str[index] == u' ' || str[index] == u'\t')) {
+            ++index;
+        }
+    };
+    skipSpaces();
+    while(index < str.size()) {
+        QChar ch = str[index++];
+        if(ch == u'\\') {
+            if(index >= str.size()) {
+                //QSettings::IniFormat does not chop trailing spaces before a backslash at the end:
+                chopLimit = current.size();
+                break;
+            }
+            ch = str[index++];
+            bool known = false;
+            for(auto& code : escapeCodes) {
+                if(ch == code[0]) {
+                    current += QChar{code[1]};
+                    known = true;
+                    break;
+                }
+            }
+            if(!known) {
+                if(ch == u'x') {
+                    //Without any hex-digits, the escape-sequence will be skipped:
+                    if(index < str.size() && hexValue(str[index]) >= 0) {
+                        char16_t code = 0;
+                        while(index < str.size() && hexValue(str[index]) >= 0) {
+                            code = code * 16 + hexValue(str[index++]);
+                        }
+                        current += QChar{code};
+                    }
+                } else if(ch >= u'0' && ch <= u'7') {
+                    char16_t code = ch.unicode() - u'0';
+                    while(index < str.size() && str[index] >= u'0' && str[index] <= u'7') {
+                        code = code * 8 + (str[index++].unicode() - u'0');
+                    }
+                    current += QChar{code};
+                } else if(ch == u'\n' || ch == u'\r') {
+                    // A line-continuation:
+                    if(index < str.size() && (str[index] == u'\n' || str[index] == u'\r') && str[index] != ch) {
+                        ++index;
+                    }
+                }
+            }
+            chopLimit = current.size();
+        } else if(ch == u'"') {
+            currentIsQuoted = true;
+            inQuotes = !inQuotes;
+            if(!inQuotes) {
+                skipSpaces();
+            }
+        } else if(ch == u',' && !inQuotes) {
+            if(!currentIsQuoted) {
+                chopTrailingSpaces(current, chopLimit);
+            }
+            isList = true;
+            elements.push_back(current);
+            current.clear();
+            currentIsQuoted = false;
+            chopLimit = 0;
+            skipSpaces();
+        } else {
+            current += ch;
+        }
+    }
+    if(!currentIsQuoted) {
+        chopTrailingSpaces(current, chopLimit);
+    }
+    if(!isList) {
+        return stringToVariant(current);
+    }
+    elements.push_back(current);
+    for(QString& element : elements) {
+        if(element.startsWith(u'@')) {
+            if(element.size() < 2 || element.at(1) != u'@') {
+                QVariantList variants;
+                for(const QString& elem : std::as_const(elements)) {
+                    variants.push_back(stringToVariant(elem));
+                }
+                return variants;
+            }
+            element.remove(0, 1);
+        }
+    }
+    return elements;
+}
+
+bool isIniSpace(QChar ch) {
+    return ch == u' ' || ch == u'\t' || ch == u'\n' || ch == u'\r';
+}
+
+// Determines the extent of the next logical line the same way as QSettings::IniFormat: backslashes escape line-breaks,
+// line-breaks within quotes do not end a line, and a semicolon outside of quotes starts a comment. Comment-lines will be skipped.
+// Yields false if there is no more line.
+bool readIniLine(QStringView data, qsizetype& dataPos, qsizetype& lineStart, qsizetype& lineLength, qsizetype& equalsPos) {
+    const qsizetype dataLength = data.size();
+    bool inQuotes = false;
+    equalsPos = -1;
+    lineStart = dataPos;
+    while(lineStart < dataLength && isIniSpace(data[lineStart])) {
+        ++lineStart;
+    }
+    qsizetype index = lineStart;
+    while(index < dataLength) {
+        QChar ch = data[index++];
+        if(ch == u'=') {
+            if(!inQuotes && equalsPos < 0) {
+                equalsPos = index - 1;
+            }
+        } else if(ch == u'\n' || ch == u'\r') {
+            if(index == lineStart + 1) {
+                ++lineStart;
+            } else if(!inQuotes) {
+                --index;
+                break;
+            }
+        } else if(ch == u'\\') {
+            if(index < dataLength) {
+                QChar escaped = data[index++];
+                if(index < dataLength && ((escaped == u'\n' && data[index] == u'\r') || (escaped == u'\r' && data[index] == u'\n'))) {
+                    ++index;
+                }
+            }
+        } else if(ch == u'"') {
+            inQuotes = !inQuotes;
+        } else if(ch == u';') {
+            if(index == lineStart + 1) {
+                //A comment-line:
+                while(index < dataLength && data[index] != u'\n' && data[index] != u'\r') {
+                    ++index;
+                }
+                while(index < dataLength && isIniSpace(data[index])) {
+                    ++index;
+                }
+                lineStart = index;
+            } else if(!inQuotes) {
+                --index;
+                break;
+            }
+        }
+    }
+    dataPos = index;
+    lineLength = index - lineStart;
+    return lineLength > 0;
+}
+
+// Parses the text of an INI-file with the same syntax as QSettings::IniFormat.
+// A QSettings::IniFormat on the same path must not be used for this: QSettings shares the parsed data per path,
+// and the QSettings that is currently reading the file holds a non-recursive lock on that data.
+void parseIni(const QByteArray& data, QSettings::SettingsMap& map) {
+    QString text = QString::fromUtf8(data);
+    if(text.startsWith(QChar{0xFEFF})) {
+        text.remove(0, 1);
+    }
+    const QStringView view{text};
+    QString section;
+    qsizetype dataPos = 0;
+    qsizetype lineStart;
+    qsizetype lineLength;
+    qsizetype equalsPos;
+    while(readIniLine(view, dataPos, lineStart, lineLength, equalsPos)) {
+        QStringView line = view.sliced(lineStart, lineLength);
+        if(line.startsWith(u'[')) {
+            qsizetype closing = line.indexOf(u']');
+            QStringView rawSection = line.sliced(1, (closing < 0 ? line.size() : closing) - 1).trimmed();
+            // "[General]" denotes the top-level, whereas an escaped "[%General]" denotes a section named "General":
+            if(rawSection.compare(QStringView{u"general"}, Qt::CaseInsensitive) == 0) {
+                section.clear();
+            } else if(rawSection.compare(QStringView{u"%general"}, Qt::CaseInsensitive) == 0) {
+                section = rawSection.sliced(1).toString();
+            } else {
+                section = unescapeKey(rawSection);
+            }
+            continue;
+        }
+        if(equalsPos < 0) {
+            continue;
+        }
+        qsizetype keyEnd = equalsPos;
+        while(keyEnd > lineStart && (view[keyEnd - 1] == u' ' || view[keyEnd - 1] == u'\t')) {
+            --keyEnd;
+        }
+        QString key = unescapeKey(view.sliced(lineStart, keyEnd - lineStart));
+        if(key.isEmpty()) {
+            continue;
+        }
+        if(!section.isEmpty()) {
+            key = section + u'/' + key;
+        }
+        map.insert(key, parseValue(view.sliced(equalsPos + 1, lineStart + lineLength - equalsPos - 1)));
+    }
+}
+
+bool readCompiledIni(QIODevice& device, QSettings::SettingsMap& map) {
+    auto sourceFile = qobject_cast<QFile*>(&device);
+    std::optional<QFileInfo> source;
+    if(sourceFile) {
+        source.emplace(sourceFile->fileName());
+        if(readImage(*source, map)) {
+            return true;
+        }
+        map.clear();
+    }
+    // The image is missing or outdated. Parse the source and compile it:
+    parseIni(device.readAll(), map);
+    if(source) {
+        writeImage(*source, map);
+    }
+    return true;
+}
+
+bool writeCompiledIni(QIODevice&, const QSettings::SettingsMap&) {
+    qCCritical(defaultLoggingCategory()).noquote().nospace() << "Cannot modify QSettings with compiled INI-format";
+    return false;
+}
+
+}
+
+QSettings::Format compiledIniFormat()
+{
+    static const QSettings::Format format = QSettings::registerFormat("ini", readCompiledIni, writeCompiledIni);
+    return format;
+}
+
+QCompiledIniConfigurationSource::QCompiledIniConfigurationSource(const QString &fileName, QObject *parent) : QConfigurationSource{parent},
+    m_fileName{fileName}
+{
+    load();
+}
+
+QCompiledIniConfigurationSource::~QCompiledIniConfigurationSource() = default;
+
+QVariant QCompiledIniConfigurationSource::value(const QString &key) const
+{
+    QReadLocker locker{&m_lock};
+    if(!m_data) {
+        return m_fallback.value(key);
+    }
+    const image_layout layout{m_data, m_entryCount, m_keyTableStart, m_valueBlobStart};
+    // The index is sorted by the keys, in the same order as QSettings::SettingsMap:
+    quint32 low = 0;
+    quint32 high = m_entryCount;
+    while(low < high) {
+        const quint32 mid = low + (high - low) / 2;
+        const index_entry entry = layout.entry(mid);
+        const int comparison = layout.key(entry).compare(key);
+        if(comparison < 0) {
+            low = mid + 1;
+        } else if(comparison > 0) {
+            high = mid;
+        } else {
+            return layout.value(entry);
+        }
+    }
+    return QVariant{};
+}
+
+QStringList QCompiledIniConfigurationSource::allKeys() const
+{
+    QReadLocker locker{&m_lock};
+    if(!m_data) {
+        return m_fallback.keys();
+    }
+    const image_layout layout{m_data, m_entryCount, m_keyTableStart, m_valueBlobStart};
+    QStringList keys;
+    keys.reserve(m_entryCount);
+    for(quint32 index = 0; index < m_entryCount; ++index) {
+        keys.push_back(layout.key(layout.entry(index)).toString());
+    }
+    return keys;
+}
+
+QString QCompiledIniConfigurationSource::fileName() const
+{
+    return m_fileName;
+}
+
+bool QCompiledIniConfigurationSource::hasFile() const
+{
+    return true;
+}
+
+void QCompiledIniConfigurationSource::refresh()
+{
+    QFileInfo info{m_fileName};
+    {
+        QReadLocker locker{&m_lock};
+        if(info.lastModified() == m_lastModified && info.size() == m_size) {
+            return;
+        }
+    }
+    load();
+}
+
+QConfigurationSource *QCompiledIniConfigurationSource::createForProfile(const QString &profile, QObject *parent) const
+{
+    QFileInfo info{m_fileName};
+    return new QCompiledIniConfigurationSource{QDir{info.path()}.filePath(info.completeBaseName()+"-"+profile+"."+info.suffix()), parent};
+}
+
+void QCompiledIniConfigurationSource::load()
+{
+    QFileInfo info{m_fileName};
+    auto image = std::make_unique<QFile>(imagePath(info));
+    std::optional<image_layout> layout;
+    QSettings::SettingsMap fallback;
+    if(info.exists()) {
+        layout = mapImage(info, *image);
+        if(!layout) {
+            // The image is missing or outdated. Parse the source, compile it and map the new image:
+            QFile file{m_fileName};
+            if(file.open(QIODevice::ReadOnly)) {
+                parseIni(file.readAll(), fallback);
+                writeImage(info, fallback);
+                image = std::make_unique<QFile>(imagePath(info));
+                layout = mapImage(info, *image);
+            }
+        }
+    }
+    if(layout) {
+        fallback.clear();
+    } else {
+        // If the image could not be written, the parsed entries will be served from memory:
+        image.reset();
+    }
+    QWriteLocker locker{&m_lock};
+    m_image = std::move(image);
+    m_data = layout ? layout->data : nullptr;
+    m_entryCount = layout ? layout->entryCount : 0;
+    m_keyTableStart = layout ? layout->keyTableStart : 0;
+    m_valueBlobStart = layout ? layout->valueBlobStart : 0;
+    m_fallback = std::move(fallback);
+    m_lastModified = info.lastModified();
+    m_size = info.size();
+}
+
+}
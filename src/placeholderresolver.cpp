@@ -1,107 +1,130 @@
 #include "placeholderresolver.h"
+#include <QVarLengthArray>
+#include <array>
 namespace mcnepp::qtdi::detail {
 
-    QVariant PlaceholderResolver::resolve(const QString& group, QVariantMap& resolvedPlaceholders) const {
-        QString resolvedString;
-        for(auto& resolvable : m_steps) {
-            QVariant resolved = resolvable->resolve(m_context, group, resolvedPlaceholders);
-            if(!resolved.isValid()) {
-                qCCritical(m_loggingCategory).nospace() << "Could not resolve placeholder " << resolvable->placeholder();
+    namespace {
+    //The map will only be modified if the value has changed. Thus, a map that shares its data with a copy will not be detached needlessly:
+    void storePlaceholder(QVariantMap& resolvedPlaceholders, const QString& key, const QVariant& value) {
+        auto found = std::as_const(resolvedPlaceholders).find(key);
+        if(found == resolvedPlaceholders.cend() || *found != value) {
+            resolvedPlaceholders.insert(key, value);
+        }
+    }
+    }
 
-                return resolved;
+    template<typename F> QVariant PlaceholderResolver::resolveInstructions(F lookup, QVariantMap& resolvedPlaceholders) const {
+        //Fast-path for an expression consisting of a single literal or a single placeholder. The result does not need to be converted to a String:
+        if(m_instructions.size() == 1) {
+            auto& instr = m_instructions.front();
+            if(!instr.isPlaceholder) {
+                return instr.text;
+            }
+            QVariant resolved = resolvePlaceholder(instr, lookup(instr), resolvedPlaceholders);
+            if(!resolved.isValid()) {
+                qCCritical(m_loggingCategory).nospace() << "Could not resolve placeholder " << instr.text;
             }
-            if(m_steps.size() == 1) {
-                return resolved;
+            return resolved;
+        }
+        QVarLengthArray<QString,8> resolvedValues;
+        qsizetype length = m_literalLength;
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                QVariant resolved = resolvePlaceholder(instr, lookup(instr), resolvedPlaceholders);
+                if(!resolved.isValid()) {
+                    qCCritical(m_loggingCategory).nospace() << "Could not resolve placeholder " << instr.text;
+                    return resolved;
+                }
+                resolvedValues.push_back(resolved.toString());
+                length += resolvedValues.back().size();
             }
-            resolvedString += resolved.toString();
+        }
+        QString resolvedString;
+        resolvedString.reserve(length);
+        auto resolvedValue = resolvedValues.cbegin();
+        for(auto& instr : m_instructions) {
+            resolvedString += instr.isPlaceholder ? *resolvedValue++ : instr.text;
         }
         return resolvedString;
     }
 
-
-    struct PlaceholderResolver::literal_step : resolvable_step {
-        virtual QVariant resolve(QApplicationContext*, const QString&, QVariantMap&) override {
-            return literal;
-        }
-
-        virtual QString placeholder() const override {
-            return QString{};
+    QVariant PlaceholderResolver::resolve(const QString& group, QVariantMap& resolvedPlaceholders) const {
+        //The group will be resolved only once for all placeholders:
+        QString resolvedGroup;
+        if(m_hasPlaceholders && !group.isEmpty()) {
+            resolvedGroup = m_context->resolveConfigValue(group, {}, resolvedPlaceholders).toString();
         }
+        return resolveInstructions([this,&resolvedGroup](const instruction& instr) {
+            return m_context->getConfigurationValue(makeConfigPath(resolvedGroup, instr.text), instr.hasWildcard);
+        }, resolvedPlaceholders);
+    }
 
+    QVariant PlaceholderResolver::resolve(const placeholder_batch& batch, QVariantMap& resolvedPlaceholders) const {
+        return resolveInstructions([&batch](const instruction& instr) { return batch.values.value(batchKey(instr, batch.group)); }, resolvedPlaceholders);
+    }
 
+    void PlaceholderResolver::storePlaceholders(const placeholder_batch& batch, QVariantMap& resolvedPlaceholders) const {
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                storePlaceholder(resolvedPlaceholders, instr.text, batch.values.value(batchKey(instr, batch.group)));
+            }
+        }
+    }
 
-        literal_step(const QString& literal) : literal{literal} {
-
+    void PlaceholderResolver::collectKeys(placeholder_batch& batch) const {
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                batch.values.insert(batchKey(instr, batch.group), QVariant{});
+            }
         }
+    }
 
-        QString literal;
-    };
+    QString PlaceholderResolver::batchKey(const instruction& instr, const QString& resolvedGroup) {
+        QString path = makeConfigPath(resolvedGroup, instr.text);
+        return instr.hasWildcard ? "*/" + path : path;
+    }
 
-    struct PlaceholderResolver::placeholder_step : resolvable_step {
-        virtual QVariant resolve(QApplicationContext* appContext, const QString& group, QVariantMap& resolvedPlaceholders) override {
-            QVariant resolved;
-            if(group.isEmpty()) {
-                resolved = appContext->getConfigurationValue(key, hasWildcard);
-            } else {
-                resolved = appContext->getConfigurationValue(makeConfigPath(appContext->resolveConfigValue(group, {}, resolvedPlaceholders).toString(), key), hasWildcard);
+    QVariant PlaceholderResolver::resolvePlaceholder(const instruction& instr, QVariant resolved, QVariantMap& resolvedPlaceholders) const {
+        if(!resolved.isValid()) {
+            //If not found in ApplicationContext's configuration, look in the map of already resolved placeholders:
+            //Use a const lookup, as operator[] would insert an entry for every missing placeholder:
+            resolved = resolvedPlaceholders.value(instr.text);
+            if(resolved.typeId() == QMetaType::QString) {
+                resolved = m_context->resolveConfigValue(resolved.toString());
             }
-            if(!resolved.isValid()) {
-                //If not found in ApplicationContext's configuration, look in the map of already resolved placeholders:
-                resolved = resolvedPlaceholders[key];
-                if(resolved.typeId() == QMetaType::QString) {
-                    resolved = appContext->resolveConfigValue(resolved.toString());
-                }
-                if(!resolved.isValid() && !defaultValue.isEmpty()) {
-                    resolved = defaultValue;
-                }
+            if(!resolved.isValid() && !instr.defaultValue.isEmpty()) {
+                resolved = instr.defaultValue;
             }
-            if(resolved.isValid()) {
-                resolvedPlaceholders[key] = resolved;
-            }
-            return resolved;
         }
-
-        virtual QString placeholder() const override {
-            return key;
+        if(resolved.isValid()) {
+            storePlaceholder(resolvedPlaceholders, instr.text, resolved);
         }
+        return resolved;
+    }
 
-
-        placeholder_step(const QString& key, const QString& defaultValue, bool hasWildcard) :
-            key{key},
-            defaultValue{defaultValue},
-            hasWildcard{hasWildcard} {
-
+    void PlaceholderResolver::addLiteral(std::vector<instruction>& instructions, const QString& literal) {
+        //Adjacent literals will be merged into one:
+        if(!instructions.empty() && !instructions.back().isPlaceholder) {
+            instructions.back().text += literal;
+        } else {
+            instructions.push_back({false, false, literal, QString{}});
         }
-
-        QString key;
-        QString defaultValue;
-        bool hasWildcard;
-
-    };
-
-    std::unique_ptr<PlaceholderResolver::resolvable_step> PlaceholderResolver::addStep(const QString& literal) {
-        return std::make_unique<literal_step>(literal);
     }
 
-    std::unique_ptr<PlaceholderResolver::resolvable_step>  PlaceholderResolver::addStep(const QString& placeholder, const QString& defaultValue, bool hasWildcard) {
-        return std::make_unique<placeholder_step>(placeholder, defaultValue, hasWildcard);
+    void PlaceholderResolver::addPlaceholder(std::vector<instruction>& instructions, const QString& placeholder, const QString& defaultValue, bool hasWildcard) {
+        instructions.push_back({true, hasWildcard, placeholder, defaultValue});
     }
 
     bool PlaceholderResolver::hasPlaceholders() const
     {
-        for(auto& resolvable : m_steps) {
-            if(!resolvable->placeholder().isEmpty()) {
-                return true;
-            }
-        }
-        return false;
+        return m_hasPlaceholders;
     }
 
     bool PlaceholderResolver::hasPlaceholder(const QString& placeholder) const
     {
         if(!placeholder.isEmpty()) {
-            for(auto& resolvable : m_steps) {
-                if(placeholder == resolvable->placeholder()) {
+            for(auto& instr : m_instructions) {
+                if(instr.isPlaceholder && placeholder == instr.text) {
                     return true;
                 }
             }
@@ -109,41 +132,186 @@ namespace mcnepp::qtdi::detail {
         return false;
     }
 
+    QStringList PlaceholderResolver::placeholders() const
+    {
+        QStringList result;
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                result.push_back(instr.text);
+            }
+        }
+        return result;
+    }
+
     void PlaceholderResolver::clearPlaceholders(QVariantMap& resolvedPlaceholders) const
     {
-        for(auto& resolvable : m_steps) {
-            if(!resolvable->placeholder().isEmpty()) {
-                resolvedPlaceholders.remove(resolvable->placeholder());
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                resolvedPlaceholders.remove(instr.text);
+            }
+        }
+    }
+
+    namespace {
+    //The characters that may have a special meaning to the tokenizer. All of them are ASCII.
+    constexpr auto specialChars = [] {
+        std::array<bool,128> table{};
+        for(char16_t ch : {u'\\', u'$', u'{', u'}', u':', u'*'}) {
+            table[ch] = true;
+        }
+        return table;
+    }();
+
+    //Yields the position of the next special character at or after pos, or the length of the String if there is none.
+    //Thus, runs of ordinary characters can be processed in bulk.
+    //Outside of a placeholder, only '$' and '\\' are special. Searching for a single character can make use of Qt's vectorized implementation.
+    qsizetype nextSpecialChar(const QString& str, qsizetype pos, bool outsidePlaceholder) {
+        if(outsidePlaceholder) {
+            QStringView view{str};
+            qsizetype end = view.indexOf(u'$', pos);
+            if(end < 0) {
+                end = view.size();
+            }
+            qsizetype backslash = view.first(end).indexOf(u'\\', pos);
+            return backslash < 0 ? end : backslash;
+        }
+        const QChar* data = str.constData();
+        const qsizetype length = str.size();
+        while(pos < length && (data[pos].unicode() >= specialChars.size() || !specialChars[data[pos].unicode()])) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    //Accumulates a token. As long as the token is a contiguous slice of the expression, it merely records the slice.
+    //Only if the token is interrupted, e.g. by an escape-character, will its characters be copied.
+    class token_builder {
+    public:
+        explicit token_builder(const QString& source) : m_source{source} {
+        }
+
+        //Appends the characters at the given position of the expression:
+        void append(qsizetype pos, qsizetype length) {
+            if(!m_copied) {
+                if(m_length == 0) {
+                    m_start = pos;
+                    m_length = length;
+                    return;
+                }
+                if(m_start + m_length == pos) {
+                    m_length += length;
+                    return;
+                }
+                copy();
+            }
+            m_buffer.append(QStringView{m_source}.sliced(pos, length));
+        }
+
+        //Appends a character that does not occur at the current position of the expression:
+        void append(QChar ch) {
+            copy();
+            m_buffer.append(ch);
+        }
+
+        bool isEmpty() const {
+            return m_copied ? m_buffer.isEmpty() : m_length == 0;
+        }
+
+        QString take() {
+            QString result;
+            if(m_copied) {
+                result = std::move(m_buffer);
+                m_buffer = QString{};
+            } else if(m_length == m_source.size()) {
+                //The token is the whole expression. Thus, it can share the expression's data:
+                result = m_source;
+            } else {
+                result = m_source.mid(m_start, m_length);
+            }
+            m_copied = false;
+            m_length = 0;
+            return result;
+        }
+
+    private:
+        void copy() {
+            if(!m_copied) {
+                m_buffer = QStringView{m_source}.sliced(m_start, m_length).toString();
+                m_copied = true;
             }
         }
+
+        const QString& m_source;
+        qsizetype m_start = 0;
+        qsizetype m_length = 0;
+        bool m_copied = false;
+        QString m_buffer;
+    };
     }
 
-    PlaceholderResolver* PlaceholderResolver::parse(const QString &placeholderString, QApplicationContext* parent)
+    std::unique_ptr<PlaceholderResolver> PlaceholderResolver::parse(const QString &placeholderString, QApplicationContext* parent)
     {
         constexpr int STATE_START = 0;
         constexpr int STATE_FOUND_DOLLAR = 1;
         constexpr int STATE_FOUND_PLACEHOLDER = 2;
         constexpr int STATE_FOUND_DEFAULT_VALUE = 3;
         constexpr int STATE_ESCAPED = 4;
-        QString token;
-        QString defaultValueToken;
-        std::deque<std::unique_ptr<resolvable_step>> steps;
+        token_builder token{placeholderString};
+        token_builder defaultValueToken{placeholderString};
+        std::vector<instruction> instructions;
 
         int lastStateBeforeEscape = STATE_START;
         int state = STATE_START;
         bool hasWildcard = false;
-        for(int pos = 0; pos < placeholderString.length(); ++pos) {
-            auto ch = placeholderString[pos];
-            switch(ch.toLatin1()) {
 
-            case '\\':
+        //Processes a run of ordinary characters:
+        auto appendOrdinary = [&](qsizetype start, qsizetype count) {
+            while(count > 0) {
+                switch(state) {
+                case STATE_FOUND_DOLLAR:
+                    token.append(QChar{'$'});
+                    state = STATE_START;
+                    [[fallthrough]];
+                case STATE_START:
+                case STATE_FOUND_PLACEHOLDER:
+                    token.append(start, count);
+                    return;
+                case STATE_FOUND_DEFAULT_VALUE:
+                    defaultValueToken.append(start, count);
+                    return;
+                case STATE_ESCAPED:
+                    //Only the first character is escaped:
+                    token.append(start, 1);
+                    state = lastStateBeforeEscape;
+                    ++start;
+                    --count;
+                    continue;
+                default:
+                    token.append(start, count);
+                    return;
+                }
+            }
+        };
+
+        const qsizetype length = placeholderString.size();
+        for(qsizetype pos = 0; pos < length; ++pos) {
+            if(qsizetype special = nextSpecialChar(placeholderString, pos, state == STATE_START); special > pos) {
+                appendOrdinary(pos, special - pos);
+                pos = special;
+                if(pos == length) {
+                    break;
+                }
+            }
+            switch(placeholderString[pos].unicode()) {
+
+            case u'\\':
                 switch(state) {
                 case STATE_ESCAPED:
-                    token += '\\';
+                    token.append(pos, 1);
                     state = lastStateBeforeEscape;
                     continue;
                 case STATE_FOUND_DOLLAR:
-                    token += '$';
+                    token.append(QChar{'$'});
                     lastStateBeforeEscape = STATE_START;
                     state = STATE_ESCAPED;
                     continue;
@@ -153,14 +321,14 @@ namespace mcnepp::qtdi::detail {
                     continue;
                 }
 
-            case '$':
+            case u'$':
                 switch(state) {
                 case STATE_ESCAPED:
-                    token += '$';
+                    token.append(pos, 1);
                     state = lastStateBeforeEscape;
                     continue;
                 case STATE_FOUND_DOLLAR:
-                    token += '$';
+                    token.append(QChar{'$'});
                     [[fallthrough]];
                 case STATE_START:
                     state = STATE_FOUND_DOLLAR;
@@ -171,61 +339,60 @@ namespace mcnepp::qtdi::detail {
                 }
 
 
-            case '{':
+            case u'{':
                 switch(state) {
                 case STATE_ESCAPED:
-                    token += '{';
+                    token.append(pos, 1);
                     state = lastStateBeforeEscape;
                     continue;
                 case STATE_FOUND_DOLLAR:
                     if(!token.isEmpty()) {
-                        steps.push_back(addStep(token));
-                        token.clear();
+                        addLiteral(instructions, token.take());
                     }
                     state = STATE_FOUND_PLACEHOLDER;
                     continue;
                 default:
                     state = STATE_START;
-                    token += ch;
+                    token.append(pos, 1);
                     continue;
                 }
 
-            case '}':
+            case u'}':
                 switch(state) {
                 case STATE_ESCAPED:
-                    token += '}';
+                    token.append(pos, 1);
                     state = lastStateBeforeEscape;
                     continue;
                 case STATE_FOUND_DEFAULT_VALUE:
                 case STATE_FOUND_PLACEHOLDER:
                     if(!token.isEmpty()) {
-                        steps.push_back(addStep(token, defaultValueToken, hasWildcard));
-                        defaultValueToken.clear();
-                        token.clear();
+                        QString key = token.take();
+                        addPlaceholder(instructions, key, defaultValueToken.take(), hasWildcard);
                         hasWildcard = false;
                     }
                     state = STATE_START;
                     continue;
                 default:
-                    token += ch;
+                    token.append(pos, 1);
                     continue;
                 }
-            case ':':
+            case u':':
                 switch(state) {
                 case STATE_ESCAPED:
-                    token += ':';
+                    token.append(pos, 1);
                     state = lastStateBeforeEscape;
                     continue;
                 case STATE_FOUND_PLACEHOLDER:
                     state = STATE_FOUND_DEFAULT_VALUE;
                     continue;
                 }
+                [[fallthrough]];
 
-            case '*':
+            case u'*':
                 switch(state) {
                 case STATE_FOUND_PLACEHOLDER:
                     //Look-ahead: The only valid wildcard notation starts with '*/'
-                    if(pos + 1 >= placeholderString.length() || placeholderString[pos+1] != '/') {
+                    if(pos + 1 >= length || placeholderString[pos+1] != '/') {
                         qCCritical(parent->loggingCategory()).nospace().noquote() << "Invalid placeholder '" << placeholderString << "'";
                         return nullptr;
                     }
@@ -233,67 +400,80 @@ namespace mcnepp::qtdi::detail {
                     ++pos;
                     continue;
                 default:
-                    token += ch;
-                    continue;
-                }
-
-            default:
-                switch(state) {
-                case STATE_FOUND_DOLLAR:
-                    token += '$';
-                    state = STATE_START;
-                    [[fallthrough]];
-                case STATE_START:
-                case STATE_FOUND_PLACEHOLDER:
-                    token += ch;
-                    continue;
-                case STATE_FOUND_DEFAULT_VALUE:
-                    defaultValueToken += ch;
-                    continue;
-                case STATE_ESCAPED:
-                    token += ch;
-                    state = lastStateBeforeEscape;
-                    continue;
-                default:
-                    token += ch;
+                    token.append(pos, 1);
                     continue;
                 }
             }
         }
         switch(state) {
         case STATE_FOUND_DOLLAR:
-            token += '$';
+            token.append(QChar{'$'});
             [[fallthrough]];
         case STATE_START:
             if(!token.isEmpty()) {
-                steps.push_back(addStep(token));
+                addLiteral(instructions, token.take());
             }
             break;
         case STATE_ESCAPED:
-            token += '\\';
-            steps.push_back(addStep(token));
+            token.append(QChar{'\\'});
+            addLiteral(instructions, token.take());
             break;
         default:
             qCCritical(parent->loggingCategory()).nospace().noquote() << "Unbalanced placeholder '" << placeholderString << "'";
             return nullptr;
 
         }
-        return new PlaceholderResolver{placeholderString, parent, std::move(steps)};
+        return std::unique_ptr<PlaceholderResolver>{new PlaceholderResolver{placeholderString, parent, std::move(instructions)}};
     }
 
     bool PlaceholderResolver::isLiteral(const QString &expression)
     {
-        return !expression.contains("${");
+        //Searching for a single character can make use of Qt's vectorized implementation:
+        QStringView view{expression};
+        for(qsizetype pos = view.indexOf(u'$'); pos >= 0 && pos + 1 < view.size(); pos = view.indexOf(u'$', pos + 1)) {
+            if(view[pos + 1] == u'{') {
+                return false;
+            }
+        }
+        return true;
     }
 
-    PlaceholderResolver::PlaceholderResolver(const QString& placeholderText, QApplicationContext* parent, std::deque<std::unique_ptr<resolvable_step>>&& steps) :
-        QObject{parent},
-        m_context{parent},
+    PlaceholderResolver::PlaceholderResolver(const QString& placeholderText, QApplicationContext* context, std::vector<instruction>&& instructions) :
+        m_context{context},
         m_placeholderText{placeholderText},
-        m_steps{std::move(steps)},
-        m_loggingCategory{parent->loggingCategory()}
+        m_instructions{std::move(instructions)},
+        m_loggingCategory{context->loggingCategory()}
     {
+        for(auto& instr : m_instructions) {
+            if(instr.isPlaceholder) {
+                m_hasPlaceholders = true;
+            } else {
+                m_literalLength += instr.text.size();
+            }
+        }
+    }
 
+    ResolverCache::ResolverCache(QApplicationContext* context) :
+        m_context{context}
+    {
+    }
+
+    const PlaceholderResolver* ResolverCache::get(const QString& expression)
+    {
+        shard& s = m_shards[qHash(expression) % SHARD_COUNT];
+        {
+            QReadLocker locker{&s.lock};
+            if(auto found = s.resolvers.find(expression); found != s.resolvers.end()) {
+                return found->second.get();
+            }
+        }
+        //Parse outside of the lock. Should another thread have cached the same expression in the meantime, its resolver wins:
+        auto parsed = PlaceholderResolver::parse(expression, m_context);
+        if(!parsed) {
+            return nullptr;
+        }
+        QWriteLocker locker{&s.lock};
+        return s.resolvers.try_emplace(expression, std::move(parsed)).first->second.get();
     }
 
 
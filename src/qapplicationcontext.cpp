@@ -53,6 +53,19 @@ bool QApplicationContext::isGlobalInstance() const
     return theInstance.load() == this;
 }
 
+QList<service_registration_handle_t> QApplicationContext::registerServiceHandles(const std::vector<detail::service_declaration>& declarations)
+{
+    QList<service_registration_handle_t> result;
+    for(auto& decl : declarations) {
+        auto handle = registerServiceHandle(decl.name, decl.descriptor, decl.config, decl.scope, decl.condition, decl.baseObject);
+        if(!handle) {
+            return {};
+        }
+        result.push_back(handle);
+    }
+    return result;
+}
+
 const QLoggingCategory& loggingCategory(registration_handle_t handle) {
     if(handle) {
         return handle->applicationContext()->loggingCategory();
@@ -11,12 +11,13 @@ QVariant QConfigurationWatcherImpl::currentValue() const
 
 
 
-QConfigurationWatcherImpl::QConfigurationWatcherImpl(PlaceholderResolver *resolver, const QString& group, QVariantMap& additionalProperties, QApplicationContext *parent) :
+QConfigurationWatcherImpl::QConfigurationWatcherImpl(const PlaceholderResolver *resolver, const QString& group, QVariantMap& additionalProperties, const QVariantMap& privatePlaceholders, QApplicationContext *parent) :
     QConfigurationWatcher{parent},
     m_resolver{resolver},
     m_context{parent},
     m_group{group},
-    m_additionalProperties{additionalProperties}
+    m_additionalProperties{additionalProperties},
+    m_privatePlaceholders{privatePlaceholders}
 {
     m_lastValue = m_resolver->resolve(group, additionalProperties);
     if(!m_lastValue.isValid()) {
@@ -27,7 +28,14 @@ QConfigurationWatcherImpl::QConfigurationWatcherImpl(PlaceholderResolver *resolv
 void QConfigurationWatcherImpl::checkChange()
 {
     m_resolver->clearPlaceholders(m_additionalProperties);
-    QVariant currentVal = m_resolver->resolve(m_group, m_additionalProperties);
+    //A private placeholder may refer to other configuration-values. Thus, it must be resolved again from its expression:
+    for(auto iter = m_privatePlaceholders.cbegin(); iter != m_privatePlaceholders.cend(); ++iter) {
+        if(m_additionalProperties.value(iter.key()) != iter.value()) {
+            m_additionalProperties.insert(iter.key(), iter.value());
+        }
+    }
+    //The ApplicationContext may re-use a memoized result if the configuration-values have not changed:
+    QVariant currentVal = m_context->resolveConfigValue(m_resolver->expression(), m_group, m_additionalProperties);
     if(!currentVal.isValid()) {
         emit errorOccurred();
         return;
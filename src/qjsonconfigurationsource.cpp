@@ -0,0 +1,107 @@
+#include "qjsonconfigurationsource.h"
+#include <QJsonDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+namespace mcnepp::qtdi {
+
+QJsonConfigurationSource::QJsonConfigurationSource(const QString &fileName, QObject *parent) : QConfigurationSource{parent},
+    m_fileName{fileName}
+{
+    load();
+}
+
+QVariant QJsonConfigurationSource::value(const QString &key) const
+{
+    QReadLocker locker{&m_lock};
+    if(auto found = m_entries.constFind(key); found != m_entries.cend()) {
+        return found->toVariant();
+    }
+    return QVariant{};
+}
+
+QStringList QJsonConfigurationSource::allKeys() const
+{
+    QReadLocker locker{&m_lock};
+    return m_keys;
+}
+
+QString QJsonConfigurationSource::fileName() const
+{
+    return m_fileName;
+}
+
+bool QJsonConfigurationSource::hasFile() const
+{
+    return true;
+}
+
+void QJsonConfigurationSource::refresh()
+{
+    QFileInfo info{m_fileName};
+    {
+        QReadLocker locker{&m_lock};
+        if(info.lastModified() == m_lastModified && info.size() == m_size) {
+            return;
+        }
+    }
+    load();
+}
+
+QConfigurationSource *QJsonConfigurationSource::createForProfile(const QString &profile, QObject *parent) const
+{
+    QFileInfo info{m_fileName};
+    return new QJsonConfigurationSource{QDir{info.path()}.filePath(info.completeBaseName()+"-"+profile+"."+info.suffix()), parent};
+}
+
+void QJsonConfigurationSource::load()
+{
+    QFileInfo info{m_fileName};
+    QHash<QString,QJsonValue> entries;
+    QStringList keys;
+    QFile file{m_fileName};
+    if(file.open(QIODevice::ReadOnly)) {
+        QJsonParseError error;
+        auto document = QJsonDocument::fromJson(file.readAll(), &error);
+        if(error.error != QJsonParseError::NoError) {
+            qCCritical(defaultLoggingCategory()).noquote().nospace() << "Could not parse JSON-configuration " << m_fileName << ": " << error.errorString() << " at offset " << error.offset;
+            //Keep the previous entries, but do not parse the file again before it has been modified again:
+            markLoaded(info);
+            return;
+        }
+        if(!document.isObject()) {
+            qCCritical(defaultLoggingCategory()).noquote().nospace() << "JSON-configuration " << m_fileName << " does not contain an object";
+            markLoaded(info);
+            return;
+        }
+        index(document.object(), QString{}, entries, keys);
+    }
+    QWriteLocker locker{&m_lock};
+    m_entries = std::move(entries);
+    m_keys = std::move(keys);
+    m_lastModified = info.lastModified();
+    m_size = info.size();
+}
+
+void QJsonConfigurationSource::markLoaded(const QFileInfo& info)
+{
+    QWriteLocker locker{&m_lock};
+    m_lastModified = info.lastModified();
+    m_size = info.size();
+}
+
+void QJsonConfigurationSource::index(const QJsonObject &object, const QString &prefix, QHash<QString, QJsonValue> &entries, QStringList &keys)
+{
+    for(auto iter = object.begin(); iter != object.end(); ++iter) {
+        QString key = detail::makeConfigPath(prefix, iter.key());
+        if(iter->isObject()) {
+            index(iter->toObject(), key, entries, keys);
+        } else {
+            entries.insert(key, iter.value());
+            keys.push_back(key);
+        }
+    }
+}
+
+}
@@ -1,20 +1,40 @@
 #include "qsettingswatcher.h"
 #include "qconfigurationwatcherimpl.h"
 #include <QFile>
+#include <QProcessEnvironment>
+#include <algorithm>
 namespace mcnepp::qtdi::detail {
 
-QSettingsWatcher::QSettingsWatcher(QApplicationContext *parent) : QObject{parent},
+namespace {
+//The watchers are indexed by the last section of a key. This covers keys within a group and keys that are looked up in parent-sections:
+QString lastSection(const QString& key) {
+    return key.mid(key.lastIndexOf('/') + 1);
+}
+
+//The environment-variable 'a.b' corresponds to the key 'a/b':
+QHash<QString,QString> readEnvironment() {
+    const auto environment = QProcessEnvironment::systemEnvironment();
+    QHash<QString,QString> result;
+    for(const QString& name : environment.keys()) {
+        result.insert(QString{name}.replace('.', '/'), environment.value(name));
+    }
+    return result;
+}
+}
+
+QSettingsWatcher::QSettingsWatcher(QApplicationContext *parent, ResolverCache& resolverCache) : QObject{parent},
     m_context{parent},
+    m_resolverCache{resolverCache},
     m_SettingsWatchTimer{new QTimer{this}},
-    m_SettingsFileWatcher{new QFileSystemWatcher{this}}
+    m_SettingsFileWatcher{new QFileSystemWatcher{this}},
+    m_lastEnvironment{readEnvironment()}
 {
     m_SettingsWatchTimer->setInterval(DEFAULT_REFRESH_MILLIS);
     connect(m_SettingsWatchTimer, &QTimer::timeout, this, [this] {refreshFromSettings(nullptr); });
-    parent->getRegistration<QSettings>().subscribe(this, &QSettingsWatcher::add);
 }
 
-void QSettingsWatcher::handleRemovedFile(QSettings *settings) {
-    qCInfo(m_context->loggingCategory()).nospace() << "QSettings-file " << settings ->fileName() << " has been deleted.";
+void QSettingsWatcher::handleRemovedFile(QConfigurationSource *settings) {
+    qCInfo(m_context->loggingCategory()).nospace() << "Configuration-file " << settings ->fileName() << " has been deleted.";
     // Check in regular intervals whether the file will re-appear:
     QTimer* checkTimer = new QTimer{};
 
@@ -22,7 +42,7 @@ void QSettingsWatcher::handleRemovedFile(QSettings *settings) {
         if(QFile::exists(settings->fileName())) {
             checkTimer->stop();
             checkTimer->deleteLater();
-            qCInfo(m_context->loggingCategory()).nospace() << "QSettings-file " << settings ->fileName() << " has been restored.";
+            qCInfo(m_context->loggingCategory()).nospace() << "Configuration-file " << settings ->fileName() << " has been restored.";
             // The file is back! Re-add it to the QFileSystemWatcher and then immediately refresh the settings:
             m_SettingsFileWatcher->addPath(settings->fileName());
             refreshFromSettings(settings);
@@ -32,51 +52,142 @@ void QSettingsWatcher::handleRemovedFile(QSettings *settings) {
 
 }
 
-void QSettingsWatcher::refreshFromSettings(QSettings *settings)
+void QSettingsWatcher::refreshFromSettings(QConfigurationSource *settings)
 {
     if(settings) {
         if(!QFile::exists(settings->fileName())) {
             handleRemovedFile(settings);
             return;
         }
-        qCInfo(m_context->loggingCategory()).nospace() << "Refreshing QSettings " << settings ->fileName();
-        settings->sync();
+        qCInfo(m_context->loggingCategory()).nospace() << "Refreshing configuration " << settings ->fileName();
+        settings->refresh();
+    } else {
+        qCInfo(m_context->loggingCategory()) << "Refreshing all configuration";
+        for(auto setting : m_Settings) {
+            if(setting) {
+                setting->refresh();
+            }
+        }
+    }
+
+    QSet<QString> changedKeys;
+    if(settings) {
+        collectChanges(settings, changedKeys);
     } else {
-        qCInfo(m_context->loggingCategory()) << "Refreshing all QSettings";
         for(auto setting : m_Settings) {
             if(setting) {
-                setting->sync();
+                collectChanges(setting, changedKeys);
             }
         }
     }
+    collectEnvironmentChanges(changedKeys);
+    if(changedKeys.isEmpty()) {
+        return;
+    }
 
+    emit settingsRefreshed(changedKeys, m_lastEnvironment);
 
-    for(auto& watched : m_watched) {
-        if(auto watcher = dynamic_cast<QConfigurationWatcherImpl*>(watched.get())) {
+    //Only the watchers that depend on a changed key need to be checked. Each of them shall be checked once, in the order of registration:
+    std::vector<std::size_t> affected;
+    QSet<QString> changedNames;
+    for(const QString& key : changedKeys) {
+        changedNames.insert(lastSection(key));
+    }
+    for(const QString& name : changedNames) {
+        if(auto found = m_dependentWatchers.constFind(name); found != m_dependentWatchers.cend()) {
+            affected.insert(affected.end(), found->begin(), found->end());
+        }
+    }
+    if(affected.empty()) {
+        return;
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+    qCDebug(m_context->loggingCategory()).nospace() << changedKeys.size() << " configuration-keys have changed, checking " << affected.size() << " of " << m_watched.size() << " watched values";
+    for(std::size_t index : affected) {
+        if(auto watcher = dynamic_cast<QConfigurationWatcherImpl*>(m_watched[index].get())) {
             watcher->checkChange();
         }
     }
 }
 
-bool hasFile(QSettings *settings) {
-    switch(settings->format()) {
-    case QSettings::IniFormat:
-        return true;
-    case QSettings::NativeFormat:
-        return !QSysInfo::productType().contains("windows", Qt::CaseInsensitive);
-    default:
-        return false;
+void QSettingsWatcher::collectChanges(QConfigurationSource *source, QSet<QString>& changedKeys)
+{
+    auto& lastValues = m_lastValues[source];
+    QHash<QString,QVariant> currentValues;
+    const QStringList keys = source->allKeys();
+    currentValues.reserve(keys.size());
+    for(const QString& key : keys) {
+        QVariant value = source->value(key);
+        if(auto found = lastValues.constFind(key); found == lastValues.cend() || *found != value) {
+            changedKeys.insert(key);
+        }
+        currentValues.insert(key, value);
+    }
+    //Keys that have been removed count as changes, too:
+    for(auto iter = lastValues.cbegin(); iter != lastValues.cend(); ++iter) {
+        if(!currentValues.contains(iter.key())) {
+            changedKeys.insert(iter.key());
+        }
+    }
+    lastValues = std::move(currentValues);
+}
+
+void QSettingsWatcher::collectEnvironmentChanges(QSet<QString>& changedKeys)
+{
+    QHash<QString,QString> currentEnvironment = readEnvironment();
+    for(auto iter = currentEnvironment.cbegin(); iter != currentEnvironment.cend(); ++iter) {
+        if(auto found = m_lastEnvironment.constFind(iter.key()); found == m_lastEnvironment.cend() || *found != iter.value()) {
+            changedKeys.insert(iter.key());
+        }
+    }
+    for(auto iter = m_lastEnvironment.cbegin(); iter != m_lastEnvironment.cend(); ++iter) {
+        if(!currentEnvironment.contains(iter.key())) {
+            changedKeys.insert(iter.key());
+        }
+    }
+    m_lastEnvironment = std::move(currentEnvironment);
+}
+
+void QSettingsWatcher::addWatcher(QConfigurationWatcher *watcher, const PlaceholderResolver *resolver, const QString &group, const QVariantMap& privatePlaceholders)
+{
+    std::size_t index = m_watched.size();
+    m_watched.push_back(watcher);
+    QStringList names = resolver->placeholders();
+    //The value will also change if the group resolves to another section:
+    if(!PlaceholderResolver::isLiteral(group)) {
+        if(auto groupResolver = m_resolverCache.get(group)) {
+            names += groupResolver->placeholders();
+        }
+    }
+    //A private placeholder may refer to other configuration-values. The value will also change if one of those changes:
+    for(const QString& name : QStringList{names}) {
+        auto found = privatePlaceholders.constFind(name);
+        if(found != privatePlaceholders.cend() && found->typeId() == QMetaType::QString && !PlaceholderResolver::isLiteral(found->toString())) {
+            if(auto privateResolver = m_resolverCache.get(found->toString())) {
+                names += privateResolver->placeholders();
+            }
+        }
+    }
+    for(const QString& name : names) {
+        auto& dependents = m_dependentWatchers[lastSection(name)];
+        if(dependents.empty() || dependents.back() != index) {
+            dependents.push_back(index);
+        }
     }
 }
 
-void QSettingsWatcher::add(QSettings *settings) {
+void QSettingsWatcher::add(QConfigurationSource *settings) {
     m_Settings.push_back(settings);
-    if(hasFile(settings)) {
+    //No entries have been recorded for the new source yet. Thus, all of its keys will count as changed upon the next refresh:
+    m_lastValues.try_emplace(settings);
+    connect(settings, &QObject::destroyed, this, [this,settings] { m_lastValues.erase(settings); });
+    if(settings->hasFile()) {
         m_SettingsFileWatcher->addPath(settings->fileName());
         connect(m_SettingsFileWatcher, &QFileSystemWatcher::fileChanged, this, [this,settings] {refreshFromSettings(settings); });
-        qCInfo(m_context->loggingCategory()).nospace() << "Watch QSettings-file " << settings->fileName();
+        qCInfo(m_context->loggingCategory()).nospace() << "Watch configuration-file " << settings->fileName();
     } else {
-        qCInfo(m_context->loggingCategory()).nospace() << "Refresh QSettings " << settings->fileName() << " every " << autoRefreshMillis() << "milliseconds";
+        qCInfo(m_context->loggingCategory()).nospace() << "Refresh configuration " << settings->fileName() << " every " << autoRefreshMillis() << "milliseconds";
     }
 }
 
@@ -85,9 +196,9 @@ void QSettingsWatcher::setPropertyValue(const property_descriptor &propertyDescr
     qCInfo(m_context->loggingCategory()).nospace().noquote() << "Refreshed property '" << propertyDescriptor.name << "' of " << target << " with value " << value;
 }
 
-void QSettingsWatcher::addWatchedProperty(PlaceholderResolver* resolver, q_variant_converter_t variantConverter, const property_descriptor& propertyDescriptor, QObject *target, const QString& group, QVariantMap& additionalProperties)
+void QSettingsWatcher::addWatchedProperty(const PlaceholderResolver* resolver, q_variant_converter_t variantConverter, const property_descriptor& propertyDescriptor, QObject *target, const QString& group, QVariantMap& additionalProperties, const QVariantMap& privatePlaceholders)
 {
-    QConfigurationWatcher* watcher = new QConfigurationWatcherImpl{resolver, group, additionalProperties, m_context};
+    QConfigurationWatcher* watcher = new QConfigurationWatcherImpl{resolver, group, additionalProperties, privatePlaceholders, m_context};
 
     if(variantConverter) {
         connect(watcher, &QConfigurationWatcher::currentValueChanged, this, [this,propertyDescriptor,target,variantConverter](const QVariant& currentValue) {
@@ -102,13 +213,13 @@ void QSettingsWatcher::addWatchedProperty(PlaceholderResolver* resolver, q_varia
    connect(watcher, &QConfigurationWatcher::errorOccurred, this, [this,watcher,name = propertyDescriptor.name] {
         qCWarning(m_context->loggingCategory()).nospace().noquote() << "Watched property '" << name << "' could not be resolved and maintains previous value " << watcher->currentValue();
     });
-    m_watched.push_back(watcher);
+    addWatcher(watcher, resolver, group, privatePlaceholders);
     qCInfo(m_context->loggingCategory()).nospace().noquote() << "Watching property '" << propertyDescriptor.name << "' of " << target;
     m_SettingsWatchTimer->start();
 }
 
 
-QConfigurationWatcher *QSettingsWatcher::watchConfigValue(PlaceholderResolver *resolver)
+QConfigurationWatcher *QSettingsWatcher::watchConfigValue(const PlaceholderResolver *resolver)
 {
     if(!resolver) {
         return nullptr;
@@ -119,8 +230,8 @@ QConfigurationWatcher *QSettingsWatcher::watchConfigValue(PlaceholderResolver *r
 
     auto& watcher = m_watchedConfigValues[resolver->expression()];
     if(!watcher) {
-        watcher = new QConfigurationWatcherImpl{resolver, {}, m_resolvedProperties, m_context};
-        m_watched.push_back(watcher);
+        watcher = new QConfigurationWatcherImpl{resolver, {}, m_resolvedProperties, {}, m_context};
+        addWatcher(watcher, resolver, {}, {});
         qCInfo(m_context->loggingCategory()).noquote().nospace() << "Watching expression '" << resolver->expression() << "'";
     }
     m_SettingsWatchTimer->start();
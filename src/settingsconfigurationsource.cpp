@@ -0,0 +1,61 @@
+#include "settingsconfigurationsource.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QSysInfo>
+
+namespace mcnepp::qtdi::detail {
+
+SettingsConfigurationSource::SettingsConfigurationSource(QSettings *settings, QObject *parent) : QConfigurationSource{parent},
+    m_settings{settings}
+{
+}
+
+QVariant SettingsConfigurationSource::value(const QString &key) const
+{
+    return m_settings->value(key);
+}
+
+QStringList SettingsConfigurationSource::allKeys() const
+{
+    return m_settings->allKeys();
+}
+
+QString SettingsConfigurationSource::fileName() const
+{
+    return m_settings->fileName();
+}
+
+bool SettingsConfigurationSource::hasFile() const
+{
+    switch(m_settings->format()) {
+    case QSettings::IniFormat:
+        return true;
+    case QSettings::NativeFormat:
+        return !QSysInfo::productType().contains("windows", Qt::CaseInsensitive);
+    default:
+        return false;
+    }
+}
+
+void SettingsConfigurationSource::refresh()
+{
+    m_settings->sync();
+}
+
+QConfigurationSource *SettingsConfigurationSource::createForProfile(const QString &profile, QObject *parent) const
+{
+    QSettings* forProfile;
+    //If the applicationName is empty, we create a new QSettings using the fileName of the existing one:
+    if(m_settings -> applicationName().isEmpty()) {
+        QFileInfo info{m_settings -> fileName()};
+        QString withProfile = QDir{info.path()}.filePath(info.completeBaseName()+"-"+profile+"."+info.suffix());
+        forProfile = new QSettings{withProfile, m_settings->format()};
+    } else {
+        forProfile = new QSettings{m_settings->format(), m_settings->scope(), m_settings->organizationName(), m_settings->applicationName()+"-"+profile};
+    }
+    auto source = new SettingsConfigurationSource{forProfile, parent};
+    forProfile->setParent(source);
+    return source;
+}
+
+}
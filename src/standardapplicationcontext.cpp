@@ -7,8 +7,13 @@
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <QDir>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QProcessEnvironment>
+#include <queue>
 #include "standardapplicationcontext.h"
 #include "qsettingswatcher.h"
+#include "settingsconfigurationsource.h"
 
 
 
@@ -108,12 +113,6 @@ bool isBindable(const QMetaProperty& sourceProperty) {
 }
 
 
-void convertVariant(QVariant& var, q_variant_converter_t converter) {
-    if(converter) {
-        var = converter(var.toString());
-    }
-}
-
 }
 
 namespace {
@@ -151,7 +150,19 @@ inline void setParentIfNotSet(QObject* obj, QObject* newParent) {
 
 
 
-template<typename T> struct Collector : public detail::Subscription {
+///
+/// \brief A Subscription that is used internally by the ApplicationContext.
+/// <br>Subscribing with a PassiveSubscription does not count as a demand for a lazy Service.
+///
+class PassiveSubscription : public detail::Subscription {
+protected:
+    explicit PassiveSubscription(QObject* parent = nullptr) :
+        detail::Subscription{parent} {
+    }
+};
+
+
+template<typename T> struct Collector : public PassiveSubscription {
 
     Collector() {
         QObject::connect(this, &detail::Subscription::objectPublished, this, &Collector::collect);
@@ -200,18 +211,6 @@ QVariantMap initPlaceholders(const detail::service_config::map_type& properties)
 
 
 
-template<typename C,typename P> auto eraseIf(C& container, P predicate) -> std::enable_if_t<std::is_pointer_v<typename C::value_type>,typename C::value_type> {
-        auto iterator = std::find_if(container.begin(), container.end(), predicate);
-        if(iterator != container.end()) {
-            auto value = *iterator;
-            container.erase(iterator);
-            return value;
-        }
-        return nullptr;
-}
-
-
-
 template<typename C> auto pop_front(C& container) -> typename C::value_type {
         auto value = container.front();
         container.pop_front();
@@ -376,6 +375,15 @@ public:
 };
 
 
+bool isPassive(subscription_handle_t subscription) {
+    //A TemporarySubscriptionProxy is as passive as the Subscription it passes the signal through to:
+    while(dynamic_cast<TemporarySubscriptionProxy*>(subscription)) {
+        subscription = dynamic_cast<detail::Subscription*>(subscription->parent());
+    }
+    return dynamic_cast<PassiveSubscription*>(subscription);
+}
+
+
 } // End of anonymous namespace
 
 
@@ -412,10 +420,10 @@ private:
 
 
 
-class StandardApplicationContext::ProxySubscription : public detail::Subscription {
+class StandardApplicationContext::ProxySubscription : public PassiveSubscription {
 public:
     explicit ProxySubscription(registration_handle_t target, bool initiallyEnabled) :
-        detail::Subscription{target},
+        PassiveSubscription{target},
         m_target{target}    {
         if(initiallyEnabled) {
             enableSignal();
@@ -445,14 +453,23 @@ private:
 
 
 
-StandardApplicationContext::ProxyRegistrationImpl::ProxyRegistrationImpl(const std::type_info& type, const QMetaObject* metaObject, StandardApplicationContext* parent) :
+StandardApplicationContext::ProxyRegistrationImpl::ProxyRegistrationImpl(const std::type_info& type, const QMetaObject* metaObject, StandardApplicationContext* context, QObject* parent) :
     detail::ProxyRegistration{parent},
     m_type(type),
     m_meta(metaObject),
-    m_context(parent)
+    m_context(context)
 {
     proxySubscription = new ProxySubscription{this, false};
-    for(auto reg : parent->registrations) {
+}
+
+void StandardApplicationContext::ProxyRegistrationImpl::subscribeMatching() {
+    m_subscribed = true;
+    descriptor_list matching;
+    {
+        QMutexLocker<QMutex> locker{&m_context->mutex};
+        matching = m_context->registrationsMatching(m_type);
+    }
+    for(auto reg : matching) {
          add(reg);
     }
     proxySubscription->enableSignal();
@@ -460,7 +477,7 @@ StandardApplicationContext::ProxyRegistrationImpl::ProxyRegistrationImpl(const s
 
 QObjectList StandardApplicationContext::ProxyRegistrationImpl::obtainServices(descriptor_list& created) {
     QObjectList result;
-    for(auto reg : m_context -> registrations) {
+    for(auto reg : m_context -> registrationsMatching(m_type)) {
         if(canAdd(reg)) {
             result.append(reg->obtainServices(created));
         }
@@ -470,7 +487,7 @@ QObjectList StandardApplicationContext::ProxyRegistrationImpl::obtainServices(de
 
 QList<service_registration_handle_t> StandardApplicationContext::ProxyRegistrationImpl::registeredServices() const {
     QList<service_registration_handle_t> result;
-    for(auto reg : m_context -> registrations) {
+    for(auto reg : m_context -> registrationsMatching(m_type)) {
         if(canAdd(reg)) {
             result.push_back(reg);
         }
@@ -480,7 +497,8 @@ QList<service_registration_handle_t> StandardApplicationContext::ProxyRegistrati
 
 bool StandardApplicationContext::ProxyRegistrationImpl::add(
     DescriptorRegistration* reg) {
-    if (canAdd(reg)) {
+    //Before subscribeMatching() has been invoked, it will pick up all registrations, including this one:
+    if (m_subscribed && canAdd(reg)) {
         reg->subscribe(proxySubscription);
         return true;
     }
@@ -498,7 +516,7 @@ void StandardApplicationContext::ProxyRegistrationImpl::onSubscription(subscript
     detail::connect(this, subscription);
     TemporarySubscriptionProxy tempProxy{subscription};
     //By subscribing to a TemporarySubscriptionProxy, we force existing objects to be signalled immediately, while not creating any new Connections:
-    for(auto reg : m_context -> registrations) {
+    for(auto reg : m_context -> registrationsMatching(m_type)) {
         if(canAdd(reg)) {
             reg->subscribe(&tempProxy);
         }
@@ -590,7 +608,21 @@ StandardApplicationContext::DescriptorRegistration::DescriptorRegistration(Descr
 
 bool StandardApplicationContext::DescriptorRegistration::isActiveInProfile() const
 {
-    return m_condition.matches(m_context);
+    if(m_condition.isAlways()) {
+        return true;
+    }
+    //Without a configuration-snapshot, a registered QSettings may have been modified directly. Thus, the configuration must be consulted each time:
+    if(!m_condition.hasProfiles() && !m_context->configurationSnapshotEnabled()) {
+        return m_condition.matches(m_context);
+    }
+    std::uint64_t generation = m_context->conditionGeneration.load(std::memory_order_acquire);
+    std::uint64_t cached = m_conditionCache.load(std::memory_order_relaxed);
+    if((cached >> 1) == generation) {
+        return cached & 1;
+    }
+    bool result = m_condition.matches(m_context);
+    m_conditionCache.store(generation << 1 | (result ? 1 : 0), std::memory_order_relaxed);
+    return result;
 }
 
 
@@ -639,27 +671,107 @@ bool StandardApplicationContext::ServiceRegistrationImpl::prepareService(const Q
     switch(state()) {
         case STATE_INIT:
         if(!theService) {
-                descriptor_list createdForThis;
-                theService = descriptor().create(resolveDependencies(dependencies, createdForThis));
-                //If any instances of prototypes have been created while resolving dependencies, make them children of the newly created service:
-                for(auto child : createdForThis) {
-                    setParentIfNotSet(child->getObject(), theService);
-                }
-                created.insert(created.end(), createdForThis.begin(), createdForThis.end());
-            if(theService) {
-                onDestroyed = connect(theService, &QObject::destroyed, this, &ServiceRegistrationImpl::serviceDestroyed);
-                if(provideConfig()) {
-                    m_state = STATE_PUBLISHED;
-                    emit objectPublished(theService);
-                } else {
-                    m_state = STATE_NEEDS_CONFIGURATION;
+                if(isLazy()) {
+                    //Store dependencies for deferred creation of the service:
+                    m_dependencies = dependencies;
+                    m_state = STATE_PLANNED;
+                    return true;
                 }
-            }
+                descriptor_list createdForThis;
+                auto arguments = resolveDependencies(dependencies, createdForThis);
+                adoptService(descriptor().create(arguments), createdForThis, created);
         }
     }
     return true;
 }
 
+void StandardApplicationContext::ServiceRegistrationImpl::adoptService(QObject* service, const descriptor_list& createdForThis, descriptor_list& created)
+{
+    theService = service;
+    //If any instances of prototypes have been created while resolving dependencies, make them children of the newly created service:
+    for(auto child : createdForThis) {
+        setParentIfNotSet(child->getObject(), theService);
+    }
+    created.insert(created.end(), createdForThis.begin(), createdForThis.end());
+    if(theService) {
+        onDestroyed = connect(theService, &QObject::destroyed, this, &ServiceRegistrationImpl::serviceDestroyed);
+        if(provideConfig()) {
+            m_state = STATE_PUBLISHED;
+            emit objectPublished(theService);
+        } else {
+            m_state = STATE_NEEDS_CONFIGURATION;
+        }
+    }
+}
+
+QObjectList StandardApplicationContext::ServiceRegistrationImpl::obtainServices(descriptor_list& created)
+{
+    if(m_state == STATE_PLANNED) {
+        descriptor_list createdForThis;
+        auto arguments = resolveDependencies(m_dependencies, createdForThis);
+        adoptService(descriptor().create(arguments), createdForThis, created);
+        if(!theService) {
+            qCCritical(loggingCategory()).noquote().nospace() << "Could not create lazy " << *this;
+            return QObjectList{};
+        }
+        //Make the service a child of the ApplicationContext right away. Otherwise, it would become the child of the service it is injected into:
+        setParentIfNotSet(theService, applicationContext());
+        m_context->insertByMetaObject(this);
+        created.push_back(this);
+        qCInfo(loggingCategory()).noquote().nospace() << "Created lazy Service '" << registeredName() << "' on demand";
+    }
+    return theService ? QObjectList{theService} : QObjectList{};
+}
+
+void StandardApplicationContext::ServiceRegistrationImpl::onSubscription(subscription_handle_t subscription)
+{
+    //Subscribing to a lazy Service demands its creation, unless the Subscription is used internally.
+    //As the Service must be created in the ApplicationContext's thread, Subscriptions from other threads will just be connected:
+    if(m_state == STATE_PLANNED && !isPassive(subscription) && detail::hasCurrentThreadAffinity(m_context)) {
+        m_context->publishOnDemand(this);
+    }
+    //If the Service is already present, there is no need to connect to the signal:
+    if(isPublished()) {
+        emit subscription->objectPublished(theService);
+    } else {
+        subscription->connectTo(this);
+    }
+}
+
+bool StandardApplicationContext::ServiceRegistrationImpl::isLazy() const
+{
+    //Instances of Prototypes and Service-groups are not lazy in their own right. QSettings are needed for configuring other services:
+    if(parent() != m_context || provideConfig()) {
+        return false;
+    }
+    for(const DescriptorRegistration* self = this; self; self = self->base()) {
+        if(self->config().lazy) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StandardApplicationContext::ServiceRegistrationImpl::canBeCreatedConcurrently() const
+{
+    //QSettings will be published immediately after creation, as they are needed for configuring other services:
+    if(m_state != STATE_INIT || theService || provideConfig() || isLazy()) {
+        return false;
+    }
+    //The ApplicationContext cannot be the parent of an object that is created in another thread:
+    for(auto& d : descriptor().dependencies) {
+        if(d.kind == detail::PARENT_PLACEHOLDER_KIND) {
+            return false;
+        }
+    }
+    for(const DescriptorRegistration* self = this; self; self = self->base()) {
+        if(self->config().concurrentCreation) {
+            return true;
+        }
+    }
+    return false;
+}
+
 int StandardApplicationContext::ServiceRegistrationImpl::unpublish() {
     if(theService) {
         std::unique_ptr<QObject> srv{theService};
@@ -803,7 +915,7 @@ class StandardApplicationContext::ServiceGroupRegistration : public DescriptorRe
     virtual bool prepareService(const QVariantList& dependencies, descriptor_list& created) override {
         const QString namePattern{"%1:%2"};
         QStringList services;
-        auto groupExpression = m_resolvedPlaceholders[m_config.serviceGroupPlaceholder];
+        auto groupExpression = m_resolvedPlaceholders.value(m_config.serviceGroupPlaceholder);
         if(groupExpression.typeId() == QMetaType::QString) {
             groupExpression = m_context->resolveConfigValue(groupExpression.toString(), m_config.group, m_resolvedPlaceholders);
         }
@@ -827,9 +939,9 @@ class StandardApplicationContext::ServiceGroupRegistration : public DescriptorRe
                 for(const auto& dep_info : m_descriptor.dependencies) {
                     switch(dep_info.kind) {
                     case detail::RESOLVABLE_KIND:
-                        detail::PlaceholderResolver* resolver = m_context->getResolver(dep_info.expression);
+                        const detail::PlaceholderResolver* resolver = m_context->getResolver(dep_info.expression);
                         if(resolver && resolver->hasPlaceholder(m_config.serviceGroupPlaceholder)) {
-                            *iter = resolver->resolve(m_config.group, instanceReg->resolvedPlaceholders());
+                            *iter = m_context->resolveMemoized(resolver, m_config.group, instanceReg->resolvedPlaceholders());
                         }
                     }
                     ++iter;
@@ -895,6 +1007,7 @@ StandardApplicationContext::StandardApplicationContext(const QLoggingCategory& l
     QApplicationContext(parent),
     m_loggingCategory(loggingCategory),
     m_injectedContext(delegatingContext),
+    resolverCache{delegatingContext},
     m_activeProfiles{&defaultProfiles()}
 {
 
@@ -909,6 +1022,7 @@ StandardApplicationContext::StandardApplicationContext(const QLoggingCategory& l
 
 
     getRegistration<QSettings>().subscribe(this, &StandardApplicationContext::onSettingsAdded);
+    getRegistration<QConfigurationSource>().subscribe(this, &StandardApplicationContext::onConfigurationSourceAdded);
 
 
     registerObject<QApplicationContext>(delegatingContext, "context");
@@ -925,6 +1039,17 @@ StandardApplicationContext::~StandardApplicationContext() {
         qCInfo(loggingCategory()).noquote().nospace() << "Removed " << this << " as global instance";
     }
     unpublish();
+    //Proxies that have been created in other threads have no parent:
+    for(auto& entry : proxyRegistrationCache) {
+        if(!entry.second->parent()) {
+            delete entry.second;
+        }
+    }
+    for(auto& bucket : proxyIndex) {
+        for(auto entry = bucket.load(); entry;) {
+            delete std::exchange(entry, entry->next);
+        }
+    }
     if(m_activeProfiles != &defaultProfiles()) {
         delete m_activeProfiles;
     }
@@ -937,29 +1062,14 @@ StandardApplicationContext::~StandardApplicationContext() {
 void StandardApplicationContext::unpublish()
 {
     descriptor_list published;
-    //Unpublish in revers order:
-    std::copy_if(registrations.rbegin(), registrations.rend(), std::inserter(published, published.begin()), [](DescriptorRegistration* reg) { return reg->isPublished() && reg->isManaged();});
+    std::copy_if(registrations.begin(), registrations.end(), std::back_inserter(published), [](DescriptorRegistration* reg) { return reg->isPublished() && reg->isManaged();});
 
 
     qCInfo(loggingCategory()).noquote().nospace() << "Un-publish ApplicationContext with " << published.size() << " managed published Objects";
 
-    DescriptorRegistration* reg = nullptr;
     unsigned unpublished = 0;
-    //Do several rounds and delete those services on which no other published Services depend:
-    while(!published.empty()) {
-        reg = pop_front(published);
-    next_published:
-        for(auto depend = published.begin(); depend != published.end(); ++depend) {
-            auto dep = *depend;
-            for(auto& t : dep->descriptor().dependencies) {
-                if(reg->matches(t)) {
-                    published.erase(depend);
-                    published.push_front(reg);
-                    reg = dep;
-                    goto next_published;
-                }
-            }
-        }
+    //Services on which no other published Services depend will be un-published first, otherwise in reverse order of registration:
+    for(auto reg : plan(published, true)) {
         int u = reg->unpublish();
         if(u)        {
             unpublished += u;
@@ -978,26 +1088,56 @@ void StandardApplicationContext::unpublish()
     }
 }
 
-StandardApplicationContext::DescriptorRegistration *StandardApplicationContext::getActiveRegistrationByName(const QString &name) const
+StandardApplicationContext::DescriptorRegistration *StandardApplicationContext::getActiveRegistrationByName(QAnyStringView name) const
+{
+    //If the name has never been interned, there cannot be a registration for it:
+    return getActiveRegistrationByName(nameAtoms.find(name));
+}
+
+StandardApplicationContext::DescriptorRegistration *StandardApplicationContext::getActiveRegistrationByName(detail::atom_t name) const
 {
     auto found = registrationsByName.find(name);
+    return found != registrationsByName.end() ? selectActiveRegistration(name, found->second) : nullptr;
+}
+
+template<typename C> StandardApplicationContext::DescriptorRegistration *StandardApplicationContext::selectActiveRegistration(detail::atom_t name, const C& candidates) const
+{
     DescriptorRegistration* reg = nullptr;
-    if(found != registrationsByName.end()) {
-        for(auto candidate : found->second) {
-            if(candidate->registeredCondition().matches(const_cast<StandardApplicationContext*>(this))) {
-                if(reg) {
-                    qCCritical(loggingCategory()).noquote().nospace() << "Ambiguous registrations for name '" << name << "'" << ": " << *reg << " and " << *candidate;
-                    return nullptr;
-                }
-                reg = candidate;
+    for(auto candidate : candidates) {
+        if(candidate->isActiveInProfile()) {
+            if(reg) {
+                qCCritical(loggingCategory()).noquote().nospace() << "Ambiguous registrations for name '" << *name << "'" << ": " << *reg << " and " << *candidate;
+                return nullptr;
             }
+            reg = candidate;
         }
     }
     return reg;
 }
 
+// Superseded snapshots will not be deleted while there are readers. The last reader to leave will reclaim them.
+class StandardApplicationContext::FrozenRegistryReader {
+public:
+    explicit FrozenRegistryReader(const StandardApplicationContext& context) : m_context{context} {
+        m_context.frozenRegistryReaders.fetch_add(1);
+    }
+
+    ~FrozenRegistryReader() {
+        if(m_context.frozenRegistryReaders.fetch_sub(1) == 1 && m_context.hasSupersededRegistries.load()) {
+            m_context.reclaimFrozenRegistries();
+        }
+    }
+
+    FrozenRegistryReader(const FrozenRegistryReader&) = delete;
+
+    FrozenRegistryReader& operator=(const FrozenRegistryReader&) = delete;
+
+private:
+    const StandardApplicationContext& m_context;
+};
 
-std::pair<QVariant,StandardApplicationContext::Status> StandardApplicationContext::resolveDependency(const descriptor_list &published, DescriptorRegistration* reg, const dependency_info& d, bool allowPartial)
+
+std::pair<QVariant,StandardApplicationContext::Status> StandardApplicationContext::resolveDependency(const descriptor_set &published, DescriptorRegistration* reg, const dependency_info& d, bool allowPartial)
 {
     const std::type_info& type = d.type;
 
@@ -1007,15 +1147,16 @@ std::pair<QVariant,StandardApplicationContext::Status> StandardApplicationContex
         for(const auto& name : requiredNames) {
             auto byName = getActiveRegistrationByName(name);
             if(byName && byName->matches(type) && byName->scope() != ServiceScope::TEMPLATE) {
-                if(std::find(published.begin(), published.end(), byName) != published.end()) {
+                if(published.find(byName) != published.end()) {
                     depRegs.push_back(byName);
                 }
             }
         }
     } else {
-        for(auto pub : published) {
-            if(pub->matches(type) && pub->scope() != ServiceScope::TEMPLATE) {
-                depRegs.push_back(pub);
+        //The candidates are already in the order of registration:
+        for(auto candidate : registrationsMatching(type)) {
+            if(candidate->scope() != ServiceScope::TEMPLATE && published.find(candidate) != published.end()) {
+                depRegs.push_back(candidate);
             }
         }
     }
@@ -1038,7 +1179,7 @@ std::pair<QVariant,StandardApplicationContext::Status> StandardApplicationContex
             }
             resolved = resolver->resolve(reg->config().group, reg->resolvedPlaceholders());
             if(resolved.isValid()) {
-                detail::convertVariant(resolved, d.variantConverter);
+                resolved = convertResolved(reg->m_dependencyConversions[&d], d.variantConverter, resolved);
                 qCInfo(loggingCategory()).noquote().nospace() << "Resolved " << d << " with " << resolved;
                 return {resolved, Status::ok};
             }
@@ -1091,15 +1232,25 @@ std::pair<QVariant,StandardApplicationContext::Status> StandardApplicationContex
 
 
 
-detail::ServiceRegistration *StandardApplicationContext::getRegistrationHandle(const QString& name) const
+detail::ServiceRegistration *StandardApplicationContext::getRegistrationHandle(QAnyStringView name) const
 {
+    FrozenRegistryReader reader{*this};
+    if(auto frozen = frozenRegistry.load()) {
+        //Once frozen, nameAtoms will not be modified anymore. Thus, it is safe to look up the atom without locking:
+        if(auto found = frozen->activeByName.find(nameAtoms.find(name)); found != frozen->activeByName.end() && found->second) {
+            return found->second;
+        }
+        qCWarning(loggingCategory()).noquote().nospace() << "Could not find a Registration for name '" << name.toString() << "'";
+        return nullptr;
+    }
+
     QMutexLocker<QMutex> locker{&mutex};
 
     DescriptorRegistration* reg = getActiveRegistrationByName(name);
     if(reg) {
         return reg;
     }
-    qCWarning(loggingCategory()).noquote().nospace() << "Could not find a Registration for name '" << name << "'";
+    qCWarning(loggingCategory()).noquote().nospace() << "Could not find a Registration for name '" << name.toString() << "'";
     return nullptr;
 }
 
@@ -1129,6 +1280,14 @@ QObject* StandardApplicationContext::obtainHandleFromApplicationThread(CreateHan
 
 detail::ProxyRegistration *StandardApplicationContext::getRegistrationHandle(const std::type_info &service_type, const QMetaObject* metaObject) const
 {
+    //Proxies will never be removed. Thus, if the index contains one, it can be returned without locking:
+    auto& bucket = proxyIndex[std::hash<std::type_index>{}(service_type) % PROXY_INDEX_BUCKETS];
+    for(auto entry = bucket.load(std::memory_order_acquire); entry; entry = entry->next) {
+        if(entry->type == service_type) {
+            return entry->proxy;
+        }
+    }
+
     QMutexLocker<QMutex> locker{&mutex};
 
     auto found = proxyRegistrationCache.find(service_type);
@@ -1136,50 +1295,200 @@ detail::ProxyRegistration *StandardApplicationContext::getRegistrationHandle(con
         return found->second;
     }
     auto context = const_cast<StandardApplicationContext*>(this);
-    ProxyRegistrationImpl* proxyReg = dynamic_cast<ProxyRegistrationImpl*>(context->obtainHandleFromApplicationThread([&service_type,metaObject,context] {
-        return new ProxyRegistrationImpl{service_type, metaObject, context};
-    }));
-
-    if(proxyReg) {
-        proxyRegistrationCache.insert({service_type, proxyReg});
+    ProxyRegistrationImpl* proxyReg;
+    bool inContextThread = detail::hasCurrentThreadAffinity(context);
+    if(inContextThread) {
+        proxyReg = new ProxyRegistrationImpl{service_type, metaObject, context, context};
+    } else {
+        //Rather than waiting for the ApplicationContext's thread to create the proxy, we create it in this thread and hand it over.
+        //As the parent cannot be set from this thread, the proxy will be deleted explicitly in the destructor:
+        proxyReg = new ProxyRegistrationImpl{service_type, metaObject, context, nullptr};
+        proxyReg->moveToThread(thread());
+        //The registrations may only be subscribed to in the ApplicationContext's thread, as publication modifies them without holding the mutex.
+        //The ApplicationContext's thread will do so before it publishes the next service, or as soon as it processes events:
+        pendingProxies.push_back(proxyReg);
+        hasPendingProxies.store(true);
+        QMetaObject::invokeMethod(context, &StandardApplicationContext::subscribePendingProxies, Qt::QueuedConnection);
+    }
+
+    proxyRegistrationCache.insert({service_type, proxyReg});
+    //Make the new proxy available to lock-free lookups:
+    bucket.store(new ProxyIndexEntry{service_type, proxyReg, bucket.load(std::memory_order_relaxed)}, std::memory_order_release);
+    locker.unlock();
+    if(inContextThread) {
+        proxyReg->subscribeMatching();
     }
     return proxyReg;
 }
 
+void StandardApplicationContext::refreeze(DescriptorRegistration* retired) const
+{
+    auto frozen = std::make_unique<FrozenRegistry>();
+    //The Conditions are evaluated here, in the ApplicationContext's thread. Lock-free lookups from other threads will not evaluate them:
+    for(auto& entry : registrationsByName) {
+        frozen->activeByName.insert({entry.first, selectActiveRegistration(entry.first, entry.second)});
+    }
+    frozen->registrations.assign(registrations.begin(), registrations.end());
+    std::copy_if(registrations.begin(), registrations.end(), std::back_inserter(frozen->activeRegistrations), std::mem_fn(&DescriptorRegistration::isActiveInProfile));
+    std::copy(registrations.begin(), registrations.end(), std::back_inserter(frozen->handles));
+    QMutexLocker<QMutex> locker{&frozenRegistriesMutex};
+    //Readers may still be consulting the current snapshot, which refers to the retired registration:
+    if(retired) {
+        frozenRegistries.back()->retired.emplace_back(retired);
+    }
+    frozenRegistry.store(frozen.get());
+    frozenRegistries.push_back(std::move(frozen));
+    hasSupersededRegistries.store(frozenRegistries.size() > 1);
+    //A reader that starts after this point will see the new snapshot. Thus, if there are no readers now, the superseded snapshots cannot be consulted anymore.
+    //Otherwise, the last reader will reclaim them:
+    if(frozenRegistryReaders.load() == 0) {
+        frozenRegistries.erase(frozenRegistries.begin(), frozenRegistries.end() - 1);
+        hasSupersededRegistries.store(false);
+    }
+}
+
+void StandardApplicationContext::reclaimFrozenRegistries() const
+{
+    QMutexLocker<QMutex> locker{&frozenRegistriesMutex};
+    //While the lock is being held, no new snapshot can be made current. Thus, a reader that starts after this point will consult the current one:
+    if(frozenRegistryReaders.load() == 0 && frozenRegistries.size() > 1) {
+        frozenRegistries.erase(frozenRegistries.begin(), frozenRegistries.end() - 1);
+        hasSupersededRegistries.store(false);
+    }
+}
+
+bool StandardApplicationContext::freeze()
+{
+    if(!detail::hasCurrentThreadAffinity(this)) {
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot freeze ApplicationContext in different thread";
+        return false;
+    }
+    QMutexLocker<QMutex> locker{&mutex};
+    if(!frozenRegistry.load()) {
+        refreeze();
+        qCInfo(loggingCategory()).noquote().nospace() << "Froze ApplicationContext with " << registrations.size() << " Registrations";
+    }
+    return true;
+}
+
+bool StandardApplicationContext::isFrozen() const
+{
+    return frozenRegistry.load() != nullptr;
+}
+
+StandardApplicationContext::descriptor_list StandardApplicationContext::plan(const descriptor_list& regs, bool forUnpublication)
+{
+    //For publication, a Registration must wait for its dependencies. For un-publication, it must wait for its dependents:
+    auto predecessors = [forUnpublication](DescriptorRegistration* reg) -> const descriptor_set& { return forUnpublication ? reg->m_dependents : reg->m_dependsOn; };
+    auto successors = [forUnpublication](DescriptorRegistration* reg) -> const descriptor_set& { return forUnpublication ? reg->m_dependsOn : reg->m_dependents; };
+
+    std::unordered_map<DescriptorRegistration*,std::size_t> inDegrees;
+    for(auto reg : regs) {
+        inDegrees.insert({reg, 0});
+    }
+    for(auto& [reg, inDegree] : inDegrees) {
+        inDegree = std::count_if(predecessors(reg).begin(), predecessors(reg).end(), [&inDegrees](DescriptorRegistration* pred) { return inDegrees.find(pred) != inDegrees.end(); });
+    }
+
+    //Barring other restrictions, the order of registration shall be kept (or reversed, for un-publication):
+    auto hasLowerPriority = [forUnpublication](DescriptorRegistration* left, DescriptorRegistration* right) {
+        return forUnpublication ? left->index() < right->index() : left->index() > right->index();
+    };
+    std::priority_queue<DescriptorRegistration*,std::vector<DescriptorRegistration*>,decltype(hasLowerPriority)> ready{hasLowerPriority};
+    for(auto& [reg, inDegree] : inDegrees) {
+        if(!inDegree) {
+            ready.push(reg);
+        }
+    }
+
+    descriptor_list result;
+    while(!ready.empty()) {
+        auto reg = ready.top();
+        ready.pop();
+        result.push_back(reg);
+        for(auto succ : successors(reg)) {
+            if(auto found = inDegrees.find(succ); found != inDegrees.end() && --found->second == 0) {
+                ready.push(succ);
+            }
+        }
+    }
+    return result;
+}
+
 void StandardApplicationContext::insertByName(const QString &name, DescriptorRegistration *reg)
 {
-    registrationsByName[name].insert(reg);
+    registrationsByName[nameAtoms.intern(name)].insert(reg);
 }
 
-QSettings* StandardApplicationContext::settingsForProfile(QSettings* settings, const QString& profile) {
-    QSettings* forProfile;
-    //If the applicationName is empty, we create a new QSettings using the fileName of the existing one:
-    if(settings -> applicationName().isEmpty()) {
-        QFileInfo info{settings -> fileName()};
-        QString withProfile = QDir{info.path()}.filePath(info.completeBaseName()+"-"+profile+"."+info.suffix());
-        forProfile = new QSettings{withProfile, settings->format(), m_injectedContext};
-    } else {
-        forProfile = new QSettings{settings->format(), settings->scope(), settings->organizationName(), settings->applicationName()+"-"+profile, m_injectedContext};
+void StandardApplicationContext::insertByType(DescriptorRegistration *reg)
+{
+    for(auto& type : reg->indexedTypes()) {
+        registrationsByType[type].push_back(reg);
+    }
+}
+
+void StandardApplicationContext::insertByMetaObject(DescriptorRegistration *reg)
+{
+    if(QObject* obj = reg->getObject()) {
+        for(auto meta = obj->metaObject(); meta; meta = meta->superClass()) {
+            registrationsByMetaObject[meta].insert(reg);
+        }
+    }
+}
+
+const StandardApplicationContext::descriptor_list& StandardApplicationContext::registrationsMatching(const std::type_info &type) const
+{
+    //Every registration matches QObject:
+    if(type == typeid(QObject)) {
+        return registrations;
+    }
+    static const descriptor_list noRegistrations;
+    auto found = registrationsByType.find(type);
+    return found != registrationsByType.end() ? found->second : noRegistrations;
+}
+
+QList<QConfigurationSource*> StandardApplicationContext::configurationSources(bool includeProfiles) const
+{
+    QList<QConfigurationSource*> sources;
+    //The profile-specific sources shall be searched before the others:
+    if(includeProfiles) {
+        for(auto& entry : m_profileSettings) {
+            sources.push_back(entry.second);
+        }
     }
-    return forProfile;
+    Collector<QObject> collector;
+    collector.subscribeAll(registrations);
+    QReadLocker locker{&m_settingsSourcesLock};
+    for(QObject* obj : collector.collected) {
+        //Registered QSettings are represented by their SettingsConfigurationSource:
+        if(auto settings = dynamic_cast<QSettings*>(obj)) {
+            if(auto found = m_settingsSources.find(settings); found != m_settingsSources.end()) {
+                sources.push_back(found->second);
+            }
+        } else if(auto source = dynamic_cast<QConfigurationSource*>(obj)) {
+            sources.push_back(source);
+        }
+    }
+    return sources;
 }
 
 void StandardApplicationContext::initSettingsForActiveProfiles() {
     if(m_activeProfiles != &defaultProfiles()) {
-        Collector<QSettings> collector;
-        collector.subscribeAll(registrations);
-        for(QSettings* settings : collector.collected) {
-            //Only create profile-specific QSettings if this has been explicitly requested:
-            if(!settings->value("qtdi/enableProfileSpecificSettings").toBool()) {
+        for(QConfigurationSource* source : configurationSources(false)) {
+            //Only create profile-specific sources if this has been explicitly requested:
+            if(!source->value("qtdi/enableProfileSpecificSettings").toBool()) {
                 continue;
             }
             for(const QString& profile : *m_activeProfiles) {
                 if(profile == "default") {
-                    continue; //No need to create an extra QSettings for profile "default"
+                    continue; //No need to create an extra source for profile "default"
                 }
-                QSettings*& forProfile = m_profileSettings[{profile, settings->fileName()}];
+                QConfigurationSource*& forProfile = m_profileSettings[{profile, source->fileName()}];
                 if(!forProfile) {
-                    forProfile = settingsForProfile(settings, profile);
+                    forProfile = source->createForProfile(profile, m_injectedContext);
+                    if(!forProfile) {
+                        continue;
+                    }
                     if(m_SettingsWatcher) {
                         m_SettingsWatcher->add(forProfile);
                     }
@@ -1208,6 +1517,10 @@ bool StandardApplicationContext::canChangeActiveProfiles()
 bool StandardApplicationContext::registerAlias(service_registration_handle_t reg, const QString &alias)
 {
     QMutexLocker<QMutex> locker{&mutex};
+    if(frozenRegistry.load()) {
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register alias '" << alias << "'. ApplicationContext has been frozen";
+        return false;
+    }
     if(!reg) {
         qCCritical(loggingCategory()).noquote().nospace() << "Cannot register alias '" << alias << "' for null";
         return false;
@@ -1239,6 +1552,7 @@ bool StandardApplicationContext::registerAlias(service_registration_handle_t reg
 void StandardApplicationContext::contextObjectDestroyed(DescriptorRegistration* objectRegistration)
 {
     qCInfo(loggingCategory()).noquote().nospace() << "Object for " << *objectRegistration << " has been destroyed externally";
+    QMutexLocker<QMutex> locker{&mutex};
 
     for(auto& regs : registrationsByName) {
         for(auto iter = regs.second.begin(); iter != regs.second.end();) {
@@ -1251,10 +1565,26 @@ void StandardApplicationContext::contextObjectDestroyed(DescriptorRegistration*
     }
 
 
+    for(auto& type : objectRegistration->indexedTypes()) {
+        auto& regs = registrationsByType[type];
+        regs.erase(std::remove(regs.begin(), regs.end(), objectRegistration), regs.end());
+    }
+
+    //The object has already been destroyed, thus we cannot determine its QMetaObject anymore:
+    for(auto& regs : registrationsByMetaObject) {
+        regs.second.erase(objectRegistration);
+    }
+
     auto found = std::find(registrations.begin(), registrations.end(), objectRegistration);
     if(found != registrations.end()) {
         registrations.erase(found);
-        delete objectRegistration;
+        //The registration must not be found by lock-free lookups anymore. As those may still be consulting the current snapshot,
+        //the registration will be deleted together with it:
+        if(frozenRegistry.load()) {
+            refreeze(objectRegistration);
+        } else {
+            delete objectRegistration;
+        }
     }
 }
 
@@ -1268,57 +1598,51 @@ void StandardApplicationContext::contextObjectDestroyed(DescriptorRegistration*
 /// Status::Fatal if there are non-fixable errors.<br>
 /// If allowPartial == true, the result can only be Status::Ok or Status::Fatal!
 ///
-StandardApplicationContext::Status StandardApplicationContext::validate(bool allowPartial, const descriptor_list& published, descriptor_list& unpublished)
+StandardApplicationContext::Status StandardApplicationContext::validate(bool allowPartial, const descriptor_set& published, descriptor_list& unpublished)
 {
-    descriptor_list allPublished{published.begin(), published.end()};
+    descriptor_set allPublished{published};
     descriptor_list validated; //validated contains the yet-to-be-published services in the correct order. Will be copied back to unpublished upon exit.
 
     qCDebug(loggingCategory()).noquote().nospace() << "Validating ApplicationContext with " << unpublished.size() << " unpublished Objects";
-    DescriptorRegistration* reg = nullptr;
-    Status status = Status::ok;
-    //Do several rounds and validate those services whose dependencies have already been published.
-    //For a service with an empty set of dependencies, this means that it will be validated first.
-    for(;;) {
-    fetch_next:
-        if(unpublished.empty()) {
-            break;
-        }
-        reg = pop_front(unpublished);
-    next_unpublished:
-
-        auto& dependencyInfos = reg->descriptor().dependencies;
-        for(auto& d : dependencyInfos) {
-            //If we find an unpublished dependency, we continue with that:
-            auto foundReg = eraseIf(unpublished, DescriptorRegistration::matcher(d));
-            if(foundReg) {
-                unpublished.push_front(reg); //Put the current Registration back where it came from. Will be processed after the dependency.
-                reg = foundReg;
-                goto next_unpublished;
+    descriptor_list planned = plan(unpublished, false);
+    if(planned.size() != unpublished.size()) {
+        //The registrations that have not been planned are part of a cycle, or depend on one:
+        descriptor_set plannedSet{planned.begin(), planned.end()};
+        QStringList cyclic;
+        for(auto reg : unpublished) {
+            if(plannedSet.find(reg) == plannedSet.end()) {
+                cyclic.push_back(reg->registeredName());
             }
         }
+        qCCritical(loggingCategory()).noquote().nospace() << "Cyclic dependency among " << cyclic.size() << " unpublished Objects: " << cyclic.join(", ");
+        return Status::fatal;
+    }
+    Status status = Status::ok;
+    //The services will be validated in the order of the plan. Thus, each service will be validated after its dependencies.
+    for(auto reg : planned) {
+        auto& dependencyInfos = reg->descriptor().dependencies;
+        bool resolved = true;
         if(!dependencyInfos.empty()) {
-            QObject temporaryParent;
             qCInfo(loggingCategory()).noquote().nospace() << "Resolving " << dependencyInfos.size() << " dependencies of " << *reg << ":";
             for(auto& d : dependencyInfos) {
                 auto result = resolveDependency(allPublished, reg, d, allowPartial);
-                switch(result.second) {
-                case Status::fixable:
-                    if(allowPartial) {
-                        status = Status::fixable;
-                        goto fetch_next;
-                    }
-                    [[fallthrough]];
-                case Status::fatal:
+                if(result.second == Status::fixable && allowPartial) {
+                    status = Status::fixable;
+                    resolved = false;
+                    break;
+                }
+                if(result.second != Status::ok) {
                     return Status::fatal;
-                default: break;
                 }
             }
         }
-        allPublished.push_back(reg);
-        validated.push_back(reg);
+        if(resolved) {
+            allPublished.insert(reg);
+            validated.push_back(reg);
+        }
     }
     // Copy validated yet-to-be-published services back to unpublished, now in the correct order for publication:
-    unpublished.insert(unpublished.begin(), validated.begin(), validated.end());
+    unpublished = validated;
     return status;
 }
 
@@ -1356,6 +1680,28 @@ QVariant StandardApplicationContext::resolveDependency(const QVariant &arg, desc
 }
 
 
+void StandardApplicationContext::createConcurrently(std::vector<ConcurrentCreation>& creations)
+{
+    qCInfo(loggingCategory()).noquote().nospace() << "Creating " << creations.size() << " Services concurrently";
+    QSemaphore finished;
+    QThread* targetThread = thread();
+    for(std::size_t pos = 0; pos < creations.size(); ++pos) {
+        auto& creation = creations[pos];
+        auto create = [&creation,&finished,targetThread] {
+            creation.service = creation.registration->descriptor().create(creation.arguments);
+            if(creation.service && creation.service->thread() != targetThread) {
+                creation.service->moveToThread(targetThread);
+            }
+            finished.release();
+        };
+        //The last Service will be created in this thread, as it would be waiting otherwise. The same applies if the thread-pool is saturated:
+        if(pos + 1 == creations.size() || !QThreadPool::globalInstance()->tryStart(create)) {
+            create();
+        }
+    }
+    finished.acquire(static_cast<int>(creations.size()));
+}
+
 bool StandardApplicationContext::publish(bool allowPartial)
 {
     if(!detail::hasCurrentThreadAffinity(this)) {
@@ -1365,10 +1711,13 @@ bool StandardApplicationContext::publish(bool allowPartial)
 
 
     descriptor_list allCreated;
+    descriptor_set resolvable; //Contains the same registrations as allCreated, used for fast look-up.
     descriptor_list toBePublished;
     descriptor_list needConfiguration;
     descriptor_list allRegistrations;
     Status validationResult = Status::ok;
+    // The configuration may have been modified directly since the last publication:
+    invalidateConditions();
     {
         QMutexLocker<QMutex> locker{&mutex};
         allRegistrations = registrations;
@@ -1393,14 +1742,16 @@ bool StandardApplicationContext::publish(bool allowPartial)
         case STATE_NEEDS_CONFIGURATION:
             needConfiguration.push_back(reg);
             [[fallthrough]];
+        case STATE_PLANNED:
         case STATE_PUBLISHED:
             allCreated.push_back(reg);
+            resolvable.insert(reg);
         }
     }
     if(toBePublished.empty() && needConfiguration.empty()) {
         return true;
     }
-    validationResult = validate(allowPartial, allCreated, toBePublished);
+    validationResult = validate(allowPartial, resolvable, toBePublished);
     if(validationResult == Status::fatal) {
         return false;
     }
@@ -1410,52 +1761,114 @@ bool StandardApplicationContext::publish(bool allowPartial)
     //Move QSettings to the beginning, so that they will be available for configuration of other services:
     std::stable_sort(needConfiguration.begin(), needConfiguration.end(), [](const DescriptorRegistration* left, const DescriptorRegistration* right) { return left->provideConfig() && !right->provideConfig();});
 
-    //Do several rounds and publish those services whose dependencies have already been published.
-    //For a service with an empty set of dependencies, this means that it will be published first.
+    auto onPrepared = [this,&needConfiguration,&allCreated,&resolvable](DescriptorRegistration* reg) {
+        switch(reg->state()) {
+        case STATE_NEEDS_CONFIGURATION:
+            needConfiguration.push_back(reg);
+            [[fallthrough]];
+        case STATE_PUBLISHED:
+            qCInfo(loggingCategory()).nospace().noquote() << "Created Service '" << reg->registeredName() << "'";
+            insertByMetaObject(reg);
+            break;
+        case STATE_PLANNED:
+            qCInfo(loggingCategory()).nospace().noquote() << "Deferred creation of lazy Service '" << reg->registeredName() << "'";
+        }
+        allCreated.push_back(reg);
+        resolvable.insert(reg);
+    };
+
+    //Services that may be created concurrently are collected, until a Service is encountered that depends on one of them,
+    //or that must be created in this thread:
+    std::vector<ConcurrentCreation> concurrentCreations;
+    descriptor_set pendingCreations;
+    auto createPending = [this,&concurrentCreations,&pendingCreations,&needConfiguration,onPrepared] {
+        createConcurrently(concurrentCreations);
+        for(auto& creation : concurrentCreations) {
+            creation.registration->adoptService(creation.service, creation.createdForThis, needConfiguration);
+            onPrepared(creation.registration);
+        }
+        concurrentCreations.clear();
+        pendingCreations.clear();
+    };
+
+    //The services will be created in the order of the plan, i.e. each service will be created after its dependencies.
     while(!toBePublished.empty()) {
         auto reg = pop_front(toBePublished);
+        bool concurrent = reg->canBeCreatedConcurrently();
+        if(!pendingCreations.empty() && (!concurrent || std::any_of(reg->m_dependsOn.begin(), reg->m_dependsOn.end(), [&pendingCreations](DescriptorRegistration* dep) { return pendingCreations.find(dep) != pendingCreations.end();}))) {
+            createPending();
+        }
         QVariantList dependencies;
         auto& dependencyInfos = reg->descriptor().dependencies;
         if(!dependencyInfos.empty()) {
             qCInfo(loggingCategory()).noquote().nospace() << "Resolving " << dependencyInfos.size() << " dependencies of " << *reg << ":";
             for(auto& d : dependencyInfos) {
-                auto result = resolveDependency(allCreated, reg, d, allowPartial);
+                auto result = resolveDependency(resolvable, reg, d, allowPartial);
                 dependencies.push_back(result.first);
             }
         }
 
+        if(concurrent) {
+            auto srvReg = static_cast<ServiceRegistrationImpl*>(reg);
+            ConcurrentCreation creation{srvReg};
+            creation.arguments = resolveDependencies(dependencies, creation.createdForThis);
+            concurrentCreations.push_back(std::move(creation));
+            pendingCreations.insert(reg);
+            continue;
+        }
+
         if(!reg->prepareService(dependencies, needConfiguration)) {
             qCCritical(loggingCategory()).nospace().noquote() << "Could not create Service " << *reg;
             return false;
         }
-
-        switch(reg->state()) {
-        case STATE_NEEDS_CONFIGURATION:
-            needConfiguration.push_back(reg);
-            [[fallthrough]];
-        case STATE_PUBLISHED:
-            qCInfo(loggingCategory()).nospace().noquote() << "Created Service '" << reg->registeredName() << "'";
-            [[fallthrough]];
-        default:
-            allCreated.push_back(reg);
-        }
+        onPrepared(reg);
+    }
+    if(!pendingCreations.empty()) {
+        createPending();
     }
 
 
     unsigned managed = std::count_if(allCreated.begin(), allCreated.end(), std::mem_fn(&DescriptorRegistration::isManaged));
 
-    //The services that have been instantiated during this methd-invocation will be configured in the order they have have been
+    qsizetype publishedCount = 0;
+    switch(publishCreated(needConfiguration, allCreated, allowPartial, publishedCount)) {
+    case Status::fatal:
+        return false;
+    case Status::fixable:
+        validationResult = Status::fixable;
+        break;
+    case Status::ok:
+        break;
+    }
+    qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has published " << publishedCount << " objects";
+    qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has a total number of " << allCreated.size() << " published objects of which " << managed << " are managed.";
+    if(!toBePublished.empty()) {
+        qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has " << toBePublished.size() << " unpublished objects";
+    }
+
+    if(publishedCount) {
+        emit publishedChanged();
+        emit pendingPublicationChanged();
+    }
+    return validationResult == Status::ok;
+}
+
+StandardApplicationContext::Status StandardApplicationContext::publishCreated(descriptor_list& needConfiguration, const descriptor_list& allCreated, bool allowPartial, qsizetype& publishedCount)
+{
+    //The services that have been instantiated during this method-invocation will be configured in the order they have have been
     //instantiated.
+    descriptor_list toBePublished;
+    Status result = Status::ok;
     while(!needConfiguration.empty()) {
         auto reg = pop_front(needConfiguration);
         auto configResult = configure(reg, reg->resolvedPlaceholders(), reg->getObject(), needConfiguration, allowPartial);
         switch(configResult) {
         case Status::fatal:
             qCCritical(loggingCategory()).nospace().noquote() << "Could not configure " << *reg;
-            return false;
+            return Status::fatal;
         case Status::fixable:
             qCWarning(loggingCategory()).nospace().noquote() << "Could not configure " << *reg;
-            validationResult = Status::fixable;
+            result = Status::fixable;
             continue;
 
         case Status::ok:
@@ -1463,7 +1876,6 @@ bool StandardApplicationContext::publish(bool allowPartial)
             toBePublished.push_back(reg);
         }
     }
-    qsizetype publishedCount = 0;
     QList<QApplicationContextPostProcessor*> postProcessors;
     for(auto reg : allCreated) {
         if(auto processor = dynamic_cast<QApplicationContextPostProcessor*>(reg->getObject())) {
@@ -1483,10 +1895,12 @@ bool StandardApplicationContext::publish(bool allowPartial)
         QObject* target = reg->getObject();
         if(!target) {
             qCCritical(loggingCategory()).nospace().noquote() << "Could not initialize " << *reg;
-            return false;
+            return Status::fatal;
         }
         bool initialized = init(reg, ServiceInitializationPolicy::DEFAULT);
         runPostProcessors(reg, postProcessors);
+        //A proxy that has been created in another thread must not miss the publication:
+        subscribePendingProxies();
         reg->notifyPublished();
         if(!initialized) {
             init(reg, ServiceInitializationPolicy::AFTER_PUBLICATION);
@@ -1498,33 +1912,76 @@ bool StandardApplicationContext::publish(bool allowPartial)
         ++publishedCount;
         qCInfo(loggingCategory()).noquote().nospace() << "Published " << *reg;
     }
-    qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has published " << publishedCount << " objects";
-    qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has a total number of " << allCreated.size() << " published objects of which " << managed << " are managed.";
-    if(!toBePublished.empty()) {
-        qCInfo(loggingCategory()).noquote().nospace() << "ApplicationContext has " << toBePublished.size() << " unpublished objects";
-    }
+    return result;
+}
 
+void StandardApplicationContext::publishOnDemand(DescriptorRegistration* reg)
+{
+    descriptor_list needConfiguration;
+    reg->obtainServices(needConfiguration);
+    if(needConfiguration.empty()) {
+        return;
+    }
+    descriptor_list allCreated;
+    {
+        QMutexLocker<QMutex> locker{&mutex};
+        std::copy_if(registrations.begin(), registrations.end(), std::back_inserter(allCreated), std::mem_fn(&DescriptorRegistration::isPublished));
+    }
+    allCreated.insert(allCreated.end(), needConfiguration.begin(), needConfiguration.end());
+    qsizetype publishedCount = 0;
+    if(publishCreated(needConfiguration, allCreated, false, publishedCount) != Status::ok) {
+        qCCritical(loggingCategory()).nospace().noquote() << "Could not publish lazy " << *reg;
+    }
     if(publishedCount) {
         emit publishedChanged();
-        emit pendingPublicationChanged();
     }
-    return validationResult == Status::ok;
+}
+
+void StandardApplicationContext::subscribePendingProxies()
+{
+    if(!hasPendingProxies.load()) {
+        return;
+    }
+    std::vector<ProxyRegistrationImpl*> proxies;
+    {
+        QMutexLocker<QMutex> locker{&mutex};
+        proxies.swap(pendingProxies);
+        hasPendingProxies.store(false);
+    }
+    for(auto proxy : proxies) {
+        proxy->subscribeMatching();
+    }
 }
 
 unsigned StandardApplicationContext::published() const
 {
+    FrozenRegistryReader reader{*this};
+    if(auto frozen = frozenRegistry.load()) {
+        return std::count_if(frozen->registrations.begin(), frozen->registrations.end(), std::mem_fn(&DescriptorRegistration::isPublished));
+    }
     QMutexLocker<QMutex> locker{&mutex};
     return std::count_if(registrations.begin(), registrations.end(), std::mem_fn(&DescriptorRegistration::isPublished));
 }
 
 unsigned int StandardApplicationContext::pendingPublication() const
 {
+    //Lazy Services that have not been demanded yet do not count as pending:
+    auto isPending = [](DescriptorRegistration* reg) { return !reg->isPublished() && reg->state() != STATE_PLANNED && reg->isActiveInProfile(); };
+    FrozenRegistryReader reader{*this};
+    if(auto frozen = frozenRegistry.load()) {
+        //The Conditions have already been evaluated when the snapshot was built:
+        return std::count_if(frozen->activeRegistrations.begin(), frozen->activeRegistrations.end(), [](DescriptorRegistration* reg) { return !reg->isPublished() && reg->state() != STATE_PLANNED; });
+    }
     QMutexLocker<QMutex> locker{&mutex};
-    return std::count_if(registrations.begin(), registrations.end(), [](DescriptorRegistration* reg) { return !reg->isPublished() && reg->isActiveInProfile(); });
+    return std::count_if(registrations.begin(), registrations.end(), isPending);
 }
 
 QList<service_registration_handle_t> StandardApplicationContext::getRegistrationHandles() const
 {
+    FrozenRegistryReader reader{*this};
+    if(auto frozen = frozenRegistry.load()) {
+        return frozen->handles;
+    }
     QMutexLocker<QMutex> locker{&mutex};
 
     QList<service_registration_handle_t> result;
@@ -1540,41 +1997,106 @@ service_registration_handle_t StandardApplicationContext::registerServiceHandle(
         qCCritical(loggingCategory()).noquote().nospace() << "Cannot register service in different thread";
         return nullptr;
     }
-    std::vector<ProxyRegistrationImpl*> matchingProxies;
+    if(isFrozen()) {
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register " << descriptor << ". ApplicationContext has been frozen";
+        return nullptr;
+    }
+    descriptor_list registered;
+    proxy_list matchingProxies;
     DescriptorRegistration* reg;
     {
         QMutexLocker<QMutex> locker{&mutex};
-        QString objName = name;
+        reg = registerLocked(name, descriptor, config, scope, condition, baseObj, registered, matchingProxies);
+    }
 
-        ServiceTemplateRegistration* base = nullptr;
-        switch(scope) {
-        case ServiceScope::EXTERNAL:
-            if(!baseObj) {
-                qCCritical(loggingCategory()).noquote().nospace() << "Cannot register null-object for " << descriptor;
-                return nullptr;
-            }
-            if(!condition.isAlways()) {
-                qCCritical(loggingCategory()).noquote().nospace() << "Cannot specify" << condition << " for external object " << descriptor;
-                return nullptr;
-            }
-            if(objName.isEmpty()) {
-                objName = baseObj->objectName();
+    // Emit signal(s) after mutex has been released:
+
+    for(auto& [proxy, added] : matchingProxies) {
+        proxy->add(added);
+    }
+
+    if(!registered.empty()) {
+        emit pendingPublicationChanged();
+    }
+    return reg;
+}
+
+QList<service_registration_handle_t> StandardApplicationContext::registerServiceHandles(const std::vector<detail::service_declaration>& declarations)
+{
+    if(!detail::hasCurrentThreadAffinity(this)) {
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register services in different thread";
+        return {};
+    }
+    if(isFrozen()) {
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register batch of " << declarations.size() << " services. ApplicationContext has been frozen";
+        return {};
+    }
+    descriptor_list registered;
+    proxy_list matchingProxies;
+    QList<service_registration_handle_t> result;
+    {
+        QMutexLocker<QMutex> locker{&mutex};
+        for(auto& decl : declarations) {
+            auto reg = registerLocked(decl.name, decl.descriptor, decl.config, decl.scope, decl.condition, decl.baseObject, registered, matchingProxies);
+            if(!reg) {
+                //Revert the new registrations of this batch, the most recent one first:
+                qCCritical(loggingCategory()).noquote().nospace() << "Cannot register batch of " << declarations.size() << " services. Reverting " << registered.size() << " registrations";
+                for(auto iter = registered.rbegin(); iter != registered.rend(); ++iter) {
+                    unregisterLocked(*iter);
+                }
+                return {};
             }
-            if(!objName.isEmpty()) {
-                reg = getActiveRegistrationByName(objName);
-                //If we have a registration under the same name, we'll return it only if it's for the same object and it has the same descriptor:
-                if(reg) {
-                    if(reg->getObject() == baseObj && descriptor == reg->descriptor()) {
-                        return reg;
-                    }
-                    //Otherwise, we have a conflicting registration
-                    qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Object " << baseObj << " as '" << objName << "'. Has already been registered as " << *reg;
-                    return nullptr;
+            result.push_back(reg);
+        }
+    }
+
+    // Emit signal(s) after mutex has been released:
+
+    for(auto& [proxy, added] : matchingProxies) {
+        proxy->add(added);
+    }
+
+    if(!registered.empty()) {
+        emit pendingPublicationChanged();
+    }
+    return result;
+}
+
+StandardApplicationContext::DescriptorRegistration* StandardApplicationContext::registerLocked(const QString& name, const service_descriptor& descriptor, const service_config& config, ServiceScope scope, const Condition& condition, QObject* baseObj, descriptor_list& registered, proxy_list& matchingProxies)
+{
+    DescriptorRegistration* reg;
+    QString objName = name;
+
+    ServiceTemplateRegistration* base = nullptr;
+    switch(scope) {
+    case ServiceScope::EXTERNAL:
+        if(!baseObj) {
+            qCCritical(loggingCategory()).noquote().nospace() << "Cannot register null-object for " << descriptor;
+            return nullptr;
+        }
+        if(!condition.isAlways()) {
+            qCCritical(loggingCategory()).noquote().nospace() << "Cannot specify" << condition << " for external object " << descriptor;
+            return nullptr;
+        }
+        if(objName.isEmpty()) {
+            objName = baseObj->objectName();
+        }
+        if(!objName.isEmpty()) {
+            reg = getActiveRegistrationByName(objName);
+            //If we have a registration under the same name, we'll return it only if it's for the same object and it has the same descriptor:
+            if(reg) {
+                if(reg->getObject() == baseObj && descriptor == reg->descriptor()) {
+                    return reg;
                 }
+                //Otherwise, we have a conflicting registration
+                qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Object " << baseObj << " as '" << objName << "'. Has already been registered as " << *reg;
+                return nullptr;
             }
-            //For object-registrations, even if we supply an explicit name, we still have to loop over all registrations,
-            //as we need to check whether the same object has been registered before.
-            for(auto regist : registrations) {
+        }
+        //For object-registrations, even if we supply an explicit name, we still have to check all registrations with the same QMetaObject,
+        //as we need to check whether the same object has been registered before.
+        if(auto found = registrationsByMetaObject.find(baseObj->metaObject()); found != registrationsByMetaObject.end()) {
+            for(auto regist : found->second) {
                 if(baseObj == regist->getObject()) {
                     //An identical anonymous registration is allowed:
                     if(descriptor == regist->descriptor() && objName.isEmpty()) {
@@ -1585,169 +2107,200 @@ service_registration_handle_t StandardApplicationContext::registerServiceHandle(
                     return nullptr;
                 }
             }
-            if(objName.isEmpty()) {
-                objName = makeName(*descriptor.service_types.begin());
-            }
-            reg = new ObjectRegistration{++nextIndex, objName, descriptor, baseObj, this};
+        }
+        if(objName.isEmpty()) {
+            objName = makeName(*descriptor.service_types.begin());
+        }
+        reg = new ObjectRegistration{++nextIndex, objName, descriptor, baseObj, this};
 
-            break;
+        break;
 
-        case ServiceScope::SERVICE_GROUP:
-            if(config.serviceGroupPlaceholder.isEmpty() || !config.properties[config.serviceGroupPlaceholder].expression.isValid()) {
-                qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register Service-group for " << descriptor << " with no service-group-expression";
+    case ServiceScope::SERVICE_GROUP:
+        if(config.serviceGroupPlaceholder.isEmpty() || !config.properties[config.serviceGroupPlaceholder].expression.isValid()) {
+            qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register Service-group for " << descriptor << " with no service-group-expression";
+            return nullptr;
+        }
+    case ServiceScope::SINGLETON:
+    case ServiceScope::PROTOTYPE:
+        for(auto& t : descriptor.dependencies) {
+            if(!t.isValid()) {
+                qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register " << descriptor << ". Found invalid dependency";
                 return nullptr;
             }
-        case ServiceScope::SINGLETON:
-        case ServiceScope::PROTOTYPE:
-            {
-                std::unordered_set<dependency_info> dependencies{};
-
-                if(!findTransitiveDependenciesOf(descriptor, dependencies)) {
-                    qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register " << descriptor << ". Found invalid dependency";
-                    return nullptr;
-                }
-
-                if(!checkTransitiveDependentsOn(descriptor, name, dependencies)) {
-                    qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register '" << name << "'. Cyclic dependency in dependency-chain of " << descriptor;
-                    return nullptr;
-
-                }
-            }
-            [[fallthrough]];
+        }
+        [[fallthrough]];
 
-        case ServiceScope::TEMPLATE:
-            if(!name.isEmpty()) {
-                auto found = registrationsByName.find(objName);
-                if(found != registrationsByName.end()) {
-                    for(auto regForName : found->second) {
-                        reg = regForName;
-                        //With isManaged() we test whether reg is also a ServiceRegistration (no ObjectRegistration)
-                        //If we have a registration under the same name, we'll return it only if it has the same descriptor, config and profiles:
-                        if(reg->isManaged()) {
-                            if(descriptor == reg->descriptor() && reg->config() == config && reg->m_condition == condition) {
-                                return reg;
-                            }
-                        }
-                        if(reg->m_condition.overlaps(condition)) {
-                            //Otherwise, we have a conflicting registration
-                            qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Service " << descriptor << " as '" << name << "'. Has already been registered as " << *reg;
-                            return nullptr;
-                        }
-                        //If the conditions do not overlap, we will create a new registration. We assume that only one of the registrations will be active at a time.
-                    }
-                }
-            } else {
-                //For an anonymous registration, we have to loop over all registrations:
-                for(auto regist : registrations) {
+    case ServiceScope::TEMPLATE:
+        if(!name.isEmpty()) {
+            auto found = registrationsByName.find(nameAtoms.find(objName));
+            if(found != registrationsByName.end()) {
+                for(auto regForName : found->second) {
+                    reg = regForName;
                     //With isManaged() we test whether reg is also a ServiceRegistration (no ObjectRegistration)
-                    if(regist->isManaged() && regist->config() == config) {
-                        switch(detail::match(descriptor, regist->descriptor())) {
-                        case detail::DESCRIPTOR_IDENTICAL:
-                            if(regist->m_condition == condition) {
-                                return regist;
-                            }
-                            [[fallthrough]];
-                        case detail::DESCRIPTOR_INTERSECTS:
-                            if(!regist->m_condition.overlaps(condition)) {
-                                continue;
-                            }
-                            //Otherwise, we have a conflicting registration
-                            qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Service " << descriptor << ". Has already been registered as " << *regist;
-                            return nullptr;
-                        default:
-                            continue;
+                    //If we have a registration under the same name, we'll return it only if it has the same descriptor, config and profiles:
+                    if(reg->isManaged()) {
+                        if(descriptor == reg->descriptor() && reg->config() == config && reg->m_condition == condition) {
+                            return reg;
                         }
                     }
-                }
-                objName = makeName(*descriptor.service_types.begin());
-            }
-
-            if(auto baseRegistration = dynamic_cast<service_registration_handle_t>(baseObj)) {
-                if(baseRegistration->scope() != ServiceScope::TEMPLATE) {
-                    qCCritical(loggingCategory()).noquote().nospace() << "Template-Registration " << *baseRegistration << " must have scope TEMPLATE, but has scope " << baseRegistration->scope();
-                    return nullptr;
-
-                }
-                if(baseRegistration->applicationContext() != this) {
-                    qCCritical(loggingCategory()).noquote().nospace() << "Template-Registration " << *baseRegistration << " not registered in this ApplicationContext";
-                    return nullptr;
-                }
-                if(descriptor.meta_object && baseRegistration->descriptor().meta_object) {
-                    if(!descriptor.meta_object->inherits(baseRegistration->descriptor().meta_object)) {
-                        qCCritical(loggingCategory()).noquote().nospace() << "Registration " << descriptor << " does not inherit Base-Registration " << *baseRegistration;
+                    if(reg->m_condition.overlaps(condition)) {
+                        //Otherwise, we have a conflicting registration
+                        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Service " << descriptor << " as '" << name << "'. Has already been registered as " << *reg;
                         return nullptr;
                     }
+                    //If the conditions do not overlap, we will create a new registration. We assume that only one of the registrations will be active at a time.
                 }
-                base = dynamic_cast<ServiceTemplateRegistration*>(baseRegistration);
             }
-
-            if(descriptor.meta_object && scope != ServiceScope::TEMPLATE) {
-                const service_config::map_type* props = &config.properties;
-                for(DescriptorRegistration* handle = base;;handle = handle->base() ){
-                    for(const auto& entry : props->asKeyValueRange()) {
-                        if(entry.second.configType != detail::ConfigValueType::PRIVATE && !entry.second.propertySetter && descriptor.meta_object->indexOfProperty(entry.first.toLatin1()) < 0) {
-                            qCCritical(loggingCategory()).nospace().noquote() << "Cannot register " << descriptor << " as '" << name << "'. Service-type has no property '" << entry.first << "'";
-                            return nullptr;
+        } else {
+            //For an anonymous registration, we have to loop over all registrations with the same impl_type:
+            for(auto regist : registrationsMatching(descriptor.impl_type)) {
+                //With isManaged() we test whether reg is also a ServiceRegistration (no ObjectRegistration)
+                if(regist->isManaged() && regist->config() == config) {
+                    switch(detail::match(descriptor, regist->descriptor())) {
+                    case detail::DESCRIPTOR_IDENTICAL:
+                        if(regist->m_condition == condition) {
+                            return regist;
                         }
+                        [[fallthrough]];
+                    case detail::DESCRIPTOR_INTERSECTS:
+                        if(!regist->m_condition.overlaps(condition)) {
+                            continue;
+                        }
+                        //Otherwise, we have a conflicting registration
+                        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register Service " << descriptor << ". Has already been registered as " << *regist;
+                        return nullptr;
+                    default:
+                        continue;
                     }
-                    if(!handle) {
-                        break;
-                    }
-                    props = &handle->config().properties;
                 }
             }
+            objName = makeName(*descriptor.service_types.begin());
+        }
 
-            if(!validateResolvers(descriptor, config)) {
+        if(auto baseRegistration = dynamic_cast<service_registration_handle_t>(baseObj)) {
+            if(baseRegistration->scope() != ServiceScope::TEMPLATE) {
+                qCCritical(loggingCategory()).noquote().nospace() << "Template-Registration " << *baseRegistration << " must have scope TEMPLATE, but has scope " << baseRegistration->scope();
                 return nullptr;
+
             }
-            switch(scope) {
-            case ServiceScope::PROTOTYPE:
-                reg = new PrototypeRegistration{base, ++nextIndex, objName, descriptor, config, this};
-                break;
-            case ServiceScope::SINGLETON:
-                reg = new ServiceRegistrationImpl{base, ++nextIndex, objName, descriptor, config, this};
-                break;
-            case ServiceScope::TEMPLATE:
-                reg = new ServiceTemplateRegistration{base, ++nextIndex, objName, descriptor, config, this};
-                break;
-            case ServiceScope::SERVICE_GROUP:
-                reg = new ServiceGroupRegistration{base, ++nextIndex, objName, descriptor, config, this};
-                break;
-            default:
-                reg = nullptr;
-                break;
+            if(baseRegistration->applicationContext() != this) {
+                qCCritical(loggingCategory()).noquote().nospace() << "Template-Registration " << *baseRegistration << " not registered in this ApplicationContext";
+                return nullptr;
             }
+            if(descriptor.meta_object && baseRegistration->descriptor().meta_object) {
+                if(!descriptor.meta_object->inherits(baseRegistration->descriptor().meta_object)) {
+                    qCCritical(loggingCategory()).noquote().nospace() << "Registration " << descriptor << " does not inherit Base-Registration " << *baseRegistration;
+                    return nullptr;
+                }
+            }
+            base = dynamic_cast<ServiceTemplateRegistration*>(baseRegistration);
+        }
 
-            if(base) {
-                base->add(reg);
+        if(descriptor.meta_object && scope != ServiceScope::TEMPLATE) {
+            const service_config::map_type* props = &config.properties;
+            for(DescriptorRegistration* handle = base;;handle = handle->base() ){
+                for(const auto& entry : props->asKeyValueRange()) {
+                    if(entry.second.configType != detail::ConfigValueType::PRIVATE && !entry.second.propertySetter && descriptor.meta_object->indexOfProperty(entry.first.toLatin1()) < 0) {
+                        qCCritical(loggingCategory()).nospace().noquote() << "Cannot register " << descriptor << " as '" << name << "'. Service-type has no property '" << entry.first << "'";
+                        return nullptr;
+                    }
+                }
+                if(!handle) {
+                    break;
+                }
+                props = &handle->config().properties;
             }
+        }
 
+        if(!validateResolvers(descriptor, config)) {
+            return nullptr;
+        }
+        switch(scope) {
+        case ServiceScope::PROTOTYPE:
+            reg = new PrototypeRegistration{base, ++nextIndex, objName, descriptor, config, this};
+            break;
+        case ServiceScope::SINGLETON:
+            reg = new ServiceRegistrationImpl{base, ++nextIndex, objName, descriptor, config, this};
+            break;
+        case ServiceScope::TEMPLATE:
+            reg = new ServiceTemplateRegistration{base, ++nextIndex, objName, descriptor, config, this};
+            break;
+        case ServiceScope::SERVICE_GROUP:
+            reg = new ServiceGroupRegistration{base, ++nextIndex, objName, descriptor, config, this};
             break;
         default:
-            qCCritical(loggingCategory()).noquote().nospace() << "Cannot register " << descriptor << "with scope " << scope;
+            reg = nullptr;
+            break;
+        }
+
+        //Cycles can only be introduced by registrations that will be instantiated with their dependencies:
+        if(scope != ServiceScope::TEMPLATE && !addToDependencyGraph(reg)) {
+            qCCritical(loggingCategory()).nospace().noquote() <<  "Cannot register '" << name << "'. Cyclic dependency in dependency-chain of " << descriptor;
+            delete reg;
             return nullptr;
         }
 
-        reg->m_condition = condition;
-        insertByName(objName, reg);
+        if(base) {
+            base->add(reg);
+        }
 
-        registrations.push_back(reg);
-        for(auto& entry : proxyRegistrationCache) {
-            if(entry.second->canAdd(reg)) {
-                matchingProxies.push_back(entry.second);
-            }
+        break;
+    default:
+        qCCritical(loggingCategory()).noquote().nospace() << "Cannot register " << descriptor << "with scope " << scope;
+        return nullptr;
+    }
+
+    reg->m_condition = condition;
+    insertByName(objName, reg);
+
+    registrations.push_back(reg);
+    insertByType(reg);
+    insertByMetaObject(reg);
+    //Look up the proxies for each of the indexed types, plus the one for QObject, which matches every registration:
+    auto types = reg->indexedTypes();
+    types.insert(typeid(QObject));
+    for(auto& type : types) {
+        if(auto found = proxyRegistrationCache.find(type); found != proxyRegistrationCache.end() && found->second->canAdd(reg)) {
+            matchingProxies.emplace_back(found->second, reg);
         }
-        qCInfo(loggingCategory()).noquote().nospace() << "Registered " << *reg;
     }
+    registered.push_back(reg);
+    qCInfo(loggingCategory()).noquote().nospace() << "Registered " << *reg;
+    return reg;
+}
 
-    // Emit signal(s) after mutex has been released:
+void StandardApplicationContext::unregisterLocked(DescriptorRegistration* reg)
+{
+    if(auto found = registrationsByName.find(nameAtoms.find(reg->registeredName())); found != registrationsByName.end()) {
+        found->second.erase(reg);
+    }
+    for(auto& type : reg->indexedTypes()) {
+        auto& regs = registrationsByType[type];
+        regs.erase(std::remove(regs.begin(), regs.end(), reg), regs.end());
+    }
+    for(auto& regs : registrationsByMetaObject) {
+        regs.second.erase(reg);
+    }
+    registrations.erase(std::remove(registrations.begin(), registrations.end(), reg), registrations.end());
 
-    for(auto proxy : matchingProxies) {
-        proxy->add(reg);
+    //Remove the registration from the dependency-graph:
+    for(auto dependency : reg->m_dependsOn) {
+        dependency->m_dependents.erase(reg);
+    }
+    for(auto dependent : reg->m_dependents) {
+        dependent->m_dependsOn.erase(reg);
+    }
+    for(auto& t : reg->descriptor().dependencies) {
+        auto& dependents = dependentsByType[t.type];
+        dependents.erase(std::remove_if(dependents.begin(), dependents.end(), [reg](auto& entry) { return entry.first == reg;}), dependents.end());
     }
 
-    emit pendingPublicationChanged();
-    return reg;
+    if(auto base = dynamic_cast<ServiceTemplateRegistration*>(reg->base())) {
+        auto& derived = base->derivedServices;
+        derived.erase(std::remove(derived.begin(), derived.end(), reg), derived.end());
+    }
+    qCInfo(loggingCategory()).noquote().nospace() << "Reverted registration " << *reg;
+    delete reg;
 }
 
 
@@ -1755,44 +2308,125 @@ service_registration_handle_t StandardApplicationContext::registerServiceHandle(
 
 
 
-bool StandardApplicationContext::findTransitiveDependenciesOf(const service_descriptor& descriptor, std::unordered_set<dependency_info>& result) const
+bool StandardApplicationContext::addToDependencyGraph(DescriptorRegistration* reg)
 {
-    for(auto& t : descriptor.dependencies) {
-        if(!t.isValid()) {
-            return false;
+    descriptor_set dependencies;
+    for(auto& t : reg->descriptor().dependencies) {
+        for(auto candidate : registrationsMatching(t.type)) {
+            //Only registrations that are part of the graph will be considered. A self-reference will be detected upon publication:
+            if(candidate->m_order && candidate != reg && candidate->matches(t)) {
+                dependencies.insert(candidate);
+            }
         }
-        for(auto reg : registrations) {
-            if(reg->matches(t)) {
-                result.insert(t);
-                if(!findTransitiveDependenciesOf(reg->descriptor(), result)) {
-                    return false;
+    }
+
+    descriptor_set dependents;
+    auto types = reg->indexedTypes();
+    types.insert(typeid(QObject));
+    for(auto& type : types) {
+        if(auto found = dependentsByType.find(type); found != dependentsByType.end()) {
+            for(auto& [dependent, info] : found->second) {
+                if(dependent != reg && reg->matches(*info)) {
+                    dependents.insert(dependent);
                 }
             }
         }
     }
+
+    //A new node is appended to the topological order. Thus, edges from its dependencies will never violate the order:
+    reg->m_order = ++nextOrder;
+    for(auto dependency : dependencies) {
+        dependency->m_dependents.insert(reg);
+        reg->m_dependsOn.insert(dependency);
+    }
+    for(auto dependent : dependents) {
+        reg->m_dependents.insert(dependent);
+        dependent->m_dependsOn.insert(reg);
+        if(!reorderDependencyGraph(reg, dependent)) {
+            //Roll back all edges of the new node. The order of the remaining nodes is still valid:
+            for(auto node : reg->m_dependsOn) {
+                node->m_dependents.erase(reg);
+            }
+            for(auto node : reg->m_dependents) {
+                node->m_dependsOn.erase(reg);
+            }
+            reg->m_dependsOn.clear();
+            reg->m_dependents.clear();
+            reg->m_order = 0;
+            return false;
+        }
+    }
+
+    for(auto& t : reg->descriptor().dependencies) {
+        dependentsByType[t.type].push_back({reg, &t});
+    }
     return true;
 }
 
 
-
-bool StandardApplicationContext::checkTransitiveDependentsOn(const service_descriptor& descriptor, const QString& name, const std::unordered_set<dependency_info>& dependencies) const
+bool StandardApplicationContext::reorderDependencyGraph(DescriptorRegistration* from, DescriptorRegistration* to)
 {
-    for(auto reg : registrations) {
-        for(auto& t : reg->descriptor().dependencies) {
-            if(descriptor.matches(t.type) && (!t.has_required_name() || t.expression == name))  {
-                if(std::find_if(dependencies.begin(), dependencies.end(), [reg](auto dep) { return reg->matches(dep);}) != dependencies.end()) {
-                   return false;
-                }
-                if(!checkTransitiveDependentsOn(reg->descriptor(), reg->registeredName(), dependencies)) {
-                    return false;
-                }
+    const unsigned upperBound = from->m_order;
+    const unsigned lowerBound = to->m_order;
+    if(lowerBound > upperBound) {
+        return true;
+    }
+    auto byOrder = [](DescriptorRegistration* left, DescriptorRegistration* right) { return left->m_order < right->m_order; };
+
+    //Forward-search from 'to' among the nodes that precede 'from'. If we reach 'from', we have found a cycle:
+    std::vector<DescriptorRegistration*> forward;
+    std::vector<DescriptorRegistration*> stack{to};
+    descriptor_set visited{to};
+    while(!stack.empty()) {
+        auto node = stack.back();
+        stack.pop_back();
+        forward.push_back(node);
+        for(auto dependent : node->m_dependents) {
+            if(dependent == from) {
+                return false;
+            }
+            if(dependent->m_order < upperBound && visited.insert(dependent).second) {
+                stack.push_back(dependent);
             }
         }
     }
-    return true;
-}
 
+    //Backward-search from 'from' among the nodes that succeed 'to':
+    std::vector<DescriptorRegistration*> backward;
+    stack.push_back(from);
+    visited.insert(from);
+    while(!stack.empty()) {
+        auto node = stack.back();
+        stack.pop_back();
+        backward.push_back(node);
+        for(auto dependency : node->m_dependsOn) {
+            if(dependency->m_order > lowerBound && visited.insert(dependency).second) {
+                stack.push_back(dependency);
+            }
+        }
+    }
 
+    //Re-distribute the positions of all affected nodes, so that the backward-set precedes the forward-set:
+    std::sort(forward.begin(), forward.end(), byOrder);
+    std::sort(backward.begin(), backward.end(), byOrder);
+    std::vector<unsigned> positions;
+    positions.reserve(forward.size() + backward.size());
+    for(auto node : backward) {
+        positions.push_back(node->m_order);
+    }
+    for(auto node : forward) {
+        positions.push_back(node->m_order);
+    }
+    std::sort(positions.begin(), positions.end());
+    auto position = positions.begin();
+    for(auto node : backward) {
+        node->m_order = *position++;
+    }
+    for(auto node : forward) {
+        node->m_order = *position++;
+    }
+    return true;
+}
 
 
 
@@ -1808,8 +2442,12 @@ StandardApplicationContext::DescriptorRegistration* StandardApplicationContext::
         return candidate;
     }
     candidate = nullptr;
-    //No matching name found, now we iterate over all registrations:
-    for(auto regist : registrations) {
+    //No matching name found, now we iterate over all registrations whose service-object inherits the property's type:
+    auto found = registrationsByMetaObject.find(propMetaType);
+    if(found == registrationsByMetaObject.end()) {
+        return nullptr;
+    }
+    for(auto regist : found->second) {
         if(!regist->isActiveInProfile()) {
             continue;
         }
@@ -1830,7 +2468,7 @@ StandardApplicationContext::DescriptorRegistration* StandardApplicationContext::
 
 bool StandardApplicationContext::registerBoundProperty(registration_handle_t target, const char *propName)
 {
-    return m_boundProperties[target].insert(propName).second;
+    return m_boundProperties[target].insert(expressionAtoms.intern(propName)).second;
 }
 
 
@@ -1848,9 +2486,52 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
     if(metaObject) {
         std::unordered_set<QString> usedProperties;
         descriptor_list createdForThis;
-        for(auto[key,cv] : config.properties.asKeyValueRange()) {
+        //Gather the placeholders of all properties, so that their values can be looked up in one pass:
+        detail::placeholder_batch batch;
+        //The resolver of each property, or nullptr if the property is not resolvable:
+        std::vector<const detail::PlaceholderResolver*> propertyResolvers;
+        propertyResolvers.reserve(config.properties.size());
+        bool hasPlaceholders = false;
+        for(auto& cv : config.properties) {
+            const detail::PlaceholderResolver* resolver = nullptr;
+            if((cv.configType == detail::ConfigValueType::DEFAULT || cv.configType == detail::ConfigValueType::AUTO_REFRESH_EXPRESSION) && cv.expression.typeId() == QMetaType::QString) {
+                resolver = getResolver(cv.expression.toString());
+                if(!resolver) {
+                    return Status::fatal;
+                }
+                hasPlaceholders = hasPlaceholders || resolver->hasPlaceholders();
+            }
+            propertyResolvers.push_back(resolver);
+        }
+        //With a configuration-snapshot, the results will be memoized. If the injected context has been supplied by the user, it might override getConfigurationValue(). Thus, we cannot bypass it:
+        auto snapshot = m_injectedContext == this ? configurationSnapshot() : nullptr;
+        //The memoized result of each property, or an invalid QVariant if there is none:
+        std::vector<QVariant> memoizedValues(propertyResolvers.size());
+        if(hasPlaceholders) {
+            //The group is resolved before any property. Thus, it sees only the private properties in resolvedPlaceholders, not the placeholders of other properties:
+            if(!config.group.isEmpty()) {
+                batch.group = m_injectedContext->resolveConfigValue(config.group, {}, resolvedPlaceholders).toString();
+            }
+            //The placeholders of all properties without a memoized result are looked up in one pass:
+            for(std::size_t index = 0; index < propertyResolvers.size(); ++index) {
+                auto resolver = propertyResolvers[index];
+                if(!resolver || (snapshot && resolver->hasPlaceholders() && findMemoized(resolver, batch.group, *snapshot, resolvedPlaceholders, memoizedValues[index]))) {
+                    continue;
+                }
+                resolver->collectKeys(batch);
+            }
+            if(snapshot) {
+                fetchConfigurationValues(*snapshot, batch);
+            } else {
+                fetchConfigurationValues(batch);
+            }
+        }
+        std::size_t propertyIndex = 0;
+        for(auto iter = config.properties.cbegin(); iter != config.properties.cend(); ++iter, ++propertyIndex) {
+            const QString& key = iter.key();
+            const detail::ConfigValue& cv = iter.value();
             QVariant resolvedValue = cv.expression;
-            detail::PlaceholderResolver* resolver = nullptr;
+            const detail::PlaceholderResolver* resolver = nullptr;
             bool isAutoRefreshProperty = config.autoRefresh; // If config.autoRefresh is false, we might still find a detail::ConfigValue below
             switch(cv.configType) {
             case detail::ConfigValueType::SERVICE:
@@ -1883,15 +2564,18 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
                 [[fallthrough]];
             case detail::ConfigValueType::DEFAULT:
                 if(cv.expression.typeId() == QMetaType::QString) {
-                    resolver = getResolver(cv.expression.toString());
-                    if(!resolver) {
-                        return Status::fatal;
-                    }
+                    resolver = propertyResolvers[propertyIndex];
                     // We only need to watch this property if it does contain placeholders:
                     isAutoRefreshProperty = isAutoRefreshProperty && resolver && resolver->hasPlaceholders();
-                    resolvedValue = resolver->resolve(config.group, resolvedPlaceholders);
+                    resolvedValue = memoizedValues[propertyIndex];
+                    if(!resolvedValue.isValid()) {
+                        resolvedValue = resolver->resolve(batch, resolvedPlaceholders);
+                        if(snapshot && resolver->hasPlaceholders()) {
+                            memoize(resolver, *snapshot, batch, resolvedValue);
+                        }
+                    }
                     if(resolvedValue.isValid()) {
-                        detail::convertVariant(resolvedValue, cv.variantConverter);
+                        resolvedValue = convertResolved(reg->m_propertyConversions[key], cv.variantConverter, resolvedValue);
                     }
                 } else {
                     resolvedValue = cv.expression;
@@ -1927,7 +2611,7 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
 
             if(isAutoRefreshProperty && resolver) {
                 if(autoRefreshEnabled()) {
-                    m_SettingsWatcher->addWatchedProperty(resolver, cv.variantConverter, propertyDescriptor, target, config.group, resolvedPlaceholders);
+                    m_SettingsWatcher->addWatchedProperty(resolver, cachingConverter(reg->m_propertyConversions.value(key), cv.variantConverter), propertyDescriptor, target, config.group, resolvedPlaceholders, initPlaceholders(config.properties));
                 } else {
                     qCWarning(loggingCategory()).nospace() << "Cannot watch property '" << key << "' of " << target << ", as auto-refresh has not been enabled.";
                 }
@@ -1944,7 +2628,16 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
             if(group.isEmpty()) {
                 group = reg->registeredName();
             }
-            QStringList keys = configurationKeys(group);
+            //With a configuration-snapshot, membership can be tested directly. Otherwise, the keys of the group are collected into a set:
+            auto snapshot = configurationSnapshot();
+            QSet<QString> keys;
+            if(!snapshot) {
+                const QStringList groupKeys = configurationKeys(group);
+                keys = QSet<QString>{groupKeys.begin(), groupKeys.end()};
+            }
+            auto hasKey = [&snapshot,&keys](const QString& path) {
+                return snapshot ? snapshot->containsKey(path) : keys.contains(path);
+            };
 
             for(int p = 0; p < metaObject->propertyCount(); ++p) {
                 auto prop = metaObject->property(p);
@@ -1953,7 +2646,7 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
                     continue; //Already set this property explicitly
                 }
                 QVariant propValue;
-                if(QString path = detail::makeConfigPath(group, prop.name()); keys.contains(path)) {
+                if(QString path = detail::makeConfigPath(group, prop.name()); hasKey(path)) {
                     propValue = getConfigurationValue(path);
                 } else
                 if(DescriptorRegistration* candidate = findAutowiringCandidate(reg, prop)) {
@@ -1976,6 +2669,7 @@ StandardApplicationContext::Status StandardApplicationContext::configure(Descrip
 
     }
     if(reg->base()) {
+        //This copy shares its data with resolvedPlaceholders. It will only be detached if the base has private placeholders, or if resolving the base's properties modifies it:
         QVariantMap resolvedBasePlaceholder{resolvedPlaceholders};
         resolvedBasePlaceholder.insert(reg->base()->resolvedPlaceholders());
         auto baseStatus = configure(reg->base(), resolvedBasePlaceholder, target, toBePublished, allowPartial);
@@ -2036,7 +2730,7 @@ bool StandardApplicationContext::validateResolvers(const service_descriptor& des
             }
             asString = cv.expression.toString();
         }
-        detail::PlaceholderResolver* configResolver = getResolver(asString);
+        const detail::PlaceholderResolver* configResolver = getResolver(asString);
         if(!configResolver) {
             return false;
         }
@@ -2050,25 +2744,56 @@ bool StandardApplicationContext::validateResolvers(const service_descriptor& des
 
 
 
-detail::PlaceholderResolver *StandardApplicationContext::getResolver(const QString& placeholderText)
+const detail::PlaceholderResolver *StandardApplicationContext::getResolver(const QString& placeholderText)
+{
+    return resolverCache.get(placeholderText);
+}
+
+QVariant StandardApplicationContext::convertResolved(conversion& cache, const detail::q_variant_converter_t& converter, const QVariant& resolved)
+{
+    if(!converter) {
+        return resolved;
+    }
+    QString input = resolved.toString();
+    //An unchanged value will not be converted again:
+    if(cache.converted.isValid() && cache.input == input) {
+        return cache.converted;
+    }
+    QVariant converted = converter(input);
+    constexpr auto pointerFlags = QMetaType::IsPointer | QMetaType::PointerToQObject | QMetaType::PointerToGadget |
+                                  QMetaType::SharedPointerToQObject | QMetaType::WeakPointerToQObject | QMetaType::TrackingPointerToQObject;
+    if(converted.metaType().flags() & pointerFlags) {
+        cache = {};
+    } else {
+        cache = {input, converted};
+    }
+    return converted;
+}
+
+detail::q_variant_converter_t StandardApplicationContext::cachingConverter(const conversion& initial, const detail::q_variant_converter_t& converter)
 {
-    auto& configResolver = resolverCache[placeholderText];
-    if(!configResolver) {
-        configResolver = detail::PlaceholderResolver::parse(placeholderText, m_injectedContext);
+    if(!converter) {
+        return nullptr;
     }
-    return configResolver.get();
+    return [converter,cache=std::make_shared<conversion>(initial)](const QString& str) { return convertResolved(*cache, converter, str); };
 }
 
 QStringList StandardApplicationContext::configurationKeys(const QString &section) const
 {
-    Collector<QSettings> collector;
-    collector.subscribeAll(registrations);
+    if(auto snapshot = configurationSnapshot()) {
+        QString prefix = detail::makeConfigPath(section, "");
+        QStringList sectionKeys;
+        for(auto iter = std::lower_bound(snapshot->sortedKeys.begin(), snapshot->sortedKeys.end(), prefix); iter != snapshot->sortedKeys.end() && iter->startsWith(prefix); ++iter) {
+            sectionKeys.push_back(*iter);
+        }
+        return sectionKeys;
+    }
 
     QStringList orderedKeys;
     QSet<QString> keySet;
     QString prefix = detail::makeConfigPath(section, "");
-    for(QSettings* settings : collector.collected) {
-        for(const QString& key : settings->allKeys()) {
+    for(QConfigurationSource* source : configurationSources(false)) {
+        for(const QString& key : source->allKeys()) {
             if(key.startsWith(prefix) && !keySet.contains(key))             {
                 keySet.insert(key);
                 orderedKeys.push_back(key);
@@ -2080,26 +2805,41 @@ QStringList StandardApplicationContext::configurationKeys(const QString &section
 
 
 QVariant StandardApplicationContext::getConfigurationValue(const QString& key, bool searchParentSections) const {
+    if(auto snapshot = configurationSnapshot()) {
+        return getConfigurationValue(*snapshot, key, searchParentSections);
+    }
+    return getConfigurationValue(configurationSources(true), key, searchParentSections);
+}
+
+QVariant StandardApplicationContext::getConfigurationValue(const ConfigurationSnapshot& snapshot, const QString& key, bool searchParentSections) const {
+    //The environment-variable 'a.b' corresponds to the key 'a/b' as well as to 'a.b'. Thus, a key containing a dot must be normalized:
+    auto envFound = key.contains('.') ? snapshot.environment.constFind(QString{key}.replace('.', '/')) : snapshot.environment.constFind(key);
+    if(envFound != snapshot.environment.cend()) {
+        qCDebug(loggingCategory()).noquote().nospace() << "Obtained configuration-entry: " << key << " = '" << *envFound << "' from enviroment";
+        return *envFound;
+    }
+    QVariant value = searchParentSections ? snapshot.findInParentSections(key) : snapshot.values.value(key);
+    if(value.isValid()) {
+        qCDebug(loggingCategory()).noquote().nospace() << "Obtained configuration-entry: " << key << " = " << value << " from configuration-snapshot " << snapshot.version;
+    } else {
+        qCDebug(loggingCategory()).noquote().nospace() << "No value found for configuration-entry: " << key;
+    }
+    return value;
+}
+
+QVariant StandardApplicationContext::getConfigurationValue(const QList<QConfigurationSource*>& sources, const QString& key, bool searchParentSections) const {
     if(auto bytes = QString{key}.replace('/', '.').toLocal8Bit(); qEnvironmentVariableIsSet(bytes)) {
         auto value = qEnvironmentVariable(bytes);
         qCDebug(loggingCategory()).noquote().nospace() << "Obtained configuration-entry: " << bytes << " = '" << value << "' from enviroment";
         return value;
     }
 
-    Collector<QSettings> collector;
-    //The profile-specific QSettings shall be searched before the others:
-    for(auto& entry : m_profileSettings) {
-        collector.collected.push_back(entry.second);
-    }
-
-    collector.subscribeAll(registrations);
-
     QString searchKey = key;
     do {
-        for(QSettings* settings : collector.collected) {
-            auto value = settings->value(searchKey);
+        for(QConfigurationSource* source : sources) {
+            auto value = source->value(searchKey);
             if(value.isValid()) {
-                qCDebug(loggingCategory()).noquote().nospace() << "Obtained configuration-entry: " << searchKey << " = " << value << " from " << settings->fileName();
+                qCDebug(loggingCategory()).noquote().nospace() << "Obtained configuration-entry: " << searchKey << " = " << value << " from " << source->fileName();
                 return value;
             }
         }
@@ -2109,6 +2849,106 @@ QVariant StandardApplicationContext::getConfigurationValue(const QString& key, b
     return QVariant{};
 }
 
+template<typename L> void fetchBatch(detail::placeholder_batch& batch, L lookup) {
+    for(auto iter = batch.values.begin(); iter != batch.values.end(); ++iter) {
+        const QString& path = iter.key();
+        iter.value() = path.startsWith("*/") ? lookup(path.mid(2), true) : lookup(path, false);
+    }
+}
+
+void StandardApplicationContext::fetchConfigurationValues(detail::placeholder_batch& batch) const
+{
+    //If the injected context has been supplied by the user, it might override getConfigurationValue(). Thus, we must delegate to it:
+    if(m_injectedContext != this) {
+        fetchBatch(batch, [this](const QString& key, bool searchParentSections) { return m_injectedContext->getConfigurationValue(key, searchParentSections); });
+    } else if(auto snapshot = configurationSnapshot()) {
+        fetchConfigurationValues(*snapshot, batch);
+    } else {
+        const auto sources = configurationSources(true);
+        fetchBatch(batch, [this,&sources](const QString& key, bool searchParentSections) { return getConfigurationValue(sources, key, searchParentSections); });
+    }
+}
+
+void StandardApplicationContext::fetchConfigurationValues(const ConfigurationSnapshot& snapshot, detail::placeholder_batch& batch) const
+{
+    fetchBatch(batch, [this,&snapshot](const QString& key, bool searchParentSections) { return getConfigurationValue(snapshot, key, searchParentSections); });
+}
+
+QVariant StandardApplicationContext::resolveMemoized(const detail::PlaceholderResolver* resolver, const QString& group, QVariantMap& resolvedPlaceholders)
+{
+    auto snapshot = configurationSnapshot();
+    //Without a snapshot, there is no version that would tell whether the configuration has changed.
+    //If the injected context has been supplied by the user, it might override getConfigurationValue(). Thus, we cannot bypass it:
+    if(!snapshot || !resolver->hasPlaceholders() || m_injectedContext != this) {
+        return resolver->resolve(group, resolvedPlaceholders);
+    }
+    detail::placeholder_batch batch;
+    if(!group.isEmpty()) {
+        batch.group = resolveConfigValue(group, {}, resolvedPlaceholders).toString();
+    }
+    QVariant result;
+    if(findMemoized(resolver, batch.group, *snapshot, resolvedPlaceholders, result)) {
+        return result;
+    }
+    resolver->collectKeys(batch);
+    fetchConfigurationValues(*snapshot, batch);
+    result = resolver->resolve(batch, resolvedPlaceholders);
+    memoize(resolver, *snapshot, batch, result);
+    return result;
+}
+
+bool StandardApplicationContext::findMemoized(const detail::PlaceholderResolver* resolver, const QString& resolvedGroup, const ConfigurationSnapshot& snapshot, QVariantMap& resolvedPlaceholders, QVariant& result)
+{
+    auto memoKey = std::make_pair(resolver->expression(), resolvedGroup);
+    memo_shard& shard = memoizedResults[qHash(memoKey) % MEMO_SHARD_COUNT];
+    memoized_result memo;
+    {
+        QReadLocker locker{&shard.lock};
+        auto found = shard.results.constFind(memoKey);
+        if(found == shard.results.cend()) {
+            return false;
+        }
+        memo = *found;
+    }
+    if(memo.version != snapshot.version) {
+        //The configuration has been refreshed. The result remains valid if none of the values it has read has changed:
+        detail::placeholder_batch current{memo.batch.group, memo.batch.values};
+        fetchConfigurationValues(snapshot, current);
+        if(current.values != memo.batch.values) {
+            return false;
+        }
+        QWriteLocker locker{&shard.lock};
+        //Another thread may have replaced the result in the meantime. In that case, its version is at least as recent:
+        if(auto found = shard.results.find(memoKey); found != shard.results.end() && found->version < snapshot.version && found->batch.values == memo.batch.values) {
+            found->version = snapshot.version;
+        }
+    }
+    resolver->storePlaceholders(memo.batch, resolvedPlaceholders);
+    result = memo.result;
+    return true;
+}
+
+void StandardApplicationContext::memoize(const detail::PlaceholderResolver* resolver, const ConfigurationSnapshot& snapshot, const detail::placeholder_batch& batch, const QVariant& result)
+{
+    if(!result.isValid()) {
+        return;
+    }
+    //The batch may contain the values of other resolvers, too. Only the values of this resolver shall be memoized:
+    detail::placeholder_batch own{batch.group, {}};
+    resolver->collectKeys(own);
+    for(auto iter = own.values.begin(); iter != own.values.end(); ++iter) {
+        iter.value() = batch.values.value(iter.key());
+        //Only a result that was obtained solely from the snapshot is independent of the resolvedPlaceholders:
+        if(!iter.value().isValid()) {
+            return;
+        }
+    }
+    auto memoKey = std::make_pair(resolver->expression(), batch.group);
+    memo_shard& shard = memoizedResults[qHash(memoKey) % MEMO_SHARD_COUNT];
+    QWriteLocker locker{&shard.lock};
+    shard.results.insert(memoKey, {snapshot.version, std::move(own), result});
+}
+
 
 const QLoggingCategory &StandardApplicationContext::loggingCategory() const
 {
@@ -2132,6 +2972,24 @@ bool StandardApplicationContext::event(QEvent *event)
 }
 
 void StandardApplicationContext::onSettingsAdded(QSettings * settings)
+{
+    auto source = new detail::SettingsConfigurationSource{settings, this};
+    {
+        QWriteLocker locker{&m_settingsSourcesLock};
+        m_settingsSources.insert({settings, source});
+    }
+    //The QSettings may live in another thread. Thus, remove the source immediately, before configurationSources() can see a dangling QSettings:
+    connect(settings, &QObject::destroyed, this, [this,settings] {
+        QWriteLocker locker{&m_settingsSourcesLock};
+        if(auto found = m_settingsSources.find(settings); found != m_settingsSources.end()) {
+            found->second->deleteLater();
+            m_settingsSources.erase(found);
+        }
+    }, Qt::DirectConnection);
+    onConfigurationSourceAdded(source);
+}
+
+void StandardApplicationContext::onConfigurationSourceAdded(QConfigurationSource* settings)
 {
     auto profilesSetting = settings->value("qtdi/activeProfiles");
     QStringList profiles;
@@ -2143,21 +3001,239 @@ void StandardApplicationContext::onSettingsAdded(QSettings * settings)
     if(!m_SettingsWatcher) {
         bool enabled = settings->value("qtdi/enableAutoRefresh").toBool();
         if(enabled) {
-            m_SettingsWatcher = new detail::QSettingsWatcher{this};
+            m_SettingsWatcher = new detail::QSettingsWatcher{this, resolverCache};
             connect(m_SettingsWatcher, &detail::QSettingsWatcher::autoRefreshMillisChanged, this, &StandardApplicationContext::autoRefreshMillisChanged);
-            m_SettingsWatcher->setAutoRefreshMillis(settings->value("qtdi/autoRefreshMillis", detail::QSettingsWatcher::DEFAULT_REFRESH_MILLIS).toInt());
+            connect(m_SettingsWatcher, &detail::QSettingsWatcher::settingsRefreshed, this, &StandardApplicationContext::updateConfigurationSnapshot);
+            auto refreshMillis = settings->value("qtdi/autoRefreshMillis");
+            m_SettingsWatcher->setAutoRefreshMillis(refreshMillis.isValid() ? refreshMillis.toInt() : detail::QSettingsWatcher::DEFAULT_REFRESH_MILLIS);
+            //Watch all sources that have been added before, including this one:
+            for(QConfigurationSource* source : configurationSources(true)) {
+                m_SettingsWatcher->add(source);
+            }
 
             qCInfo(loggingCategory()) << "Auto-refresh has been enabled.";
         }
+    } else {
+        m_SettingsWatcher->add(settings);
     }
+    bool profilesChanged = false;
     if(!profiles.empty() && canChangeActiveProfiles()) {
         Profiles profilesToAdd{profiles.begin(), profiles.end()};
         if(!m_activeProfiles -> contains(profilesToAdd)) {
             *m_activeProfiles += profilesToAdd;
             initSettingsForActiveProfiles();
-            emit activeProfilesChanged(*m_activeProfiles);
+            profilesChanged = true;
         }
     }
+    // The new QSettings may contain values that are referenced by Conditions:
+    refreshConfiguration();
+    if(profilesChanged) {
+        emit activeProfilesChanged(*m_activeProfiles);
+    }
+}
+
+void StandardApplicationContext::refreshConfiguration()
+{
+    if(m_configurationSnapshotEnabled) {
+        auto snapshot = std::make_shared<ConfigurationSnapshot>();
+        auto previous = configurationSnapshot();
+        snapshot->version = previous ? previous->version + 1 : 1;
+
+        //The profile-specific sources shall take precedence over the others:
+        for(QConfigurationSource* source : configurationSources(true)) {
+            for(const QString& key : source->allKeys()) {
+                if(!snapshot->values.contains(key)) {
+                    snapshot->values.insert(key, source->value(key));
+                    snapshot->sortedKeys.push_back(key);
+                }
+            }
+        }
+        const auto environment = QProcessEnvironment::systemEnvironment();
+        for(const QString& name : environment.keys()) {
+            QString key = QString{name}.replace('.', '/');
+            //Environment-variables are only listed as configuration-keys if they denote an entry within a section:
+            if(key.contains('/') && !snapshot->values.contains(key)) {
+                snapshot->sortedKeys.push_back(key);
+            }
+            snapshot->environment.insert(key, environment.value(name));
+        }
+        std::sort(snapshot->sortedKeys.begin(), snapshot->sortedKeys.end());
+        snapshot->sortedKeys.erase(std::unique(snapshot->sortedKeys.begin(), snapshot->sortedKeys.end()), snapshot->sortedKeys.end());
+        snapshot->buildFallbacks();
+        qCDebug(loggingCategory()).noquote().nospace() << "Built configuration-snapshot " << snapshot->version << " with " << snapshot->values.size() << " entries";
+        publishConfigurationSnapshot(std::move(snapshot), previous.get());
+    }
+    invalidateConditions();
+}
+
+void StandardApplicationContext::updateConfigurationSnapshot(const QSet<QString>& changedKeys, const QHash<QString,QString>& environment)
+{
+    if(auto previous = configurationSnapshot()) {
+        //Only the entries that have changed need to be looked up again. The other entries are shared with the previous snapshot:
+        auto snapshot = std::make_shared<ConfigurationSnapshot>(*previous);
+        snapshot->version = previous->version + 1;
+        snapshot->environment = environment;
+        const auto sources = configurationSources(true);
+        for(const QString& key : changedKeys) {
+            QVariant value;
+            //The profile-specific sources shall take precedence over the others:
+            for(QConfigurationSource* source : sources) {
+                value = source->value(key);
+                if(value.isValid()) {
+                    break;
+                }
+            }
+            if(value.isValid()) {
+                snapshot->values.insert(key, value);
+            } else {
+                snapshot->values.remove(key);
+            }
+            snapshot->updateFallback(key, value);
+            if(bool wasListed = previous->containsKey(key); wasListed != snapshot->containsKey(key)) {
+                auto pos = std::lower_bound(snapshot->sortedKeys.begin(), snapshot->sortedKeys.end(), key);
+                if(wasListed) {
+                    snapshot->sortedKeys.erase(pos);
+                } else {
+                    snapshot->sortedKeys.insert(pos, key);
+                }
+            }
+        }
+        qCDebug(loggingCategory()).noquote().nospace() << "Updated configuration-snapshot " << snapshot->version << " with " << changedKeys.size() << " changed entries";
+        publishConfigurationSnapshot(std::move(snapshot), previous.get());
+    }
+    invalidateConditions();
+}
+
+void StandardApplicationContext::publishConfigurationSnapshot(std::shared_ptr<const ConfigurationSnapshot> snapshot, const ConfigurationSnapshot* previous)
+{
+    std::atomic_store(&m_configurationSnapshot, std::move(snapshot));
+    if(previous) {
+        //Results that have not been used since the previous snapshot was built are discarded. The others will be re-validated upon their next use:
+        for(memo_shard& shard : memoizedResults) {
+            QWriteLocker locker{&shard.lock};
+            for(auto iter = shard.results.begin(); iter != shard.results.end();) {
+                if(iter->version < previous->version) {
+                    iter = shard.results.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+        }
+    }
+}
+
+QVariant StandardApplicationContext::ConfigurationSnapshot::findInParentSections(const QString &key) const
+{
+    if(auto found = values.constFind(key); found != values.cend()) {
+        return *found;
+    }
+    //detail::removeLastConfigPath() will not remove anything from a key without a slash, or with a slash only at the beginning:
+    qsizetype lastSlash = key.lastIndexOf('/');
+    if(lastSlash <= 0) {
+        return {};
+    }
+    auto candidates = fallbacksByName.constFind(key.sliced(lastSlash + 1));
+    if(candidates == fallbacksByName.cend()) {
+        return {};
+    }
+    //Each parent-section that detail::removeLastConfigPath() yields is a prefix of the section, ending before a slash.
+    //The candidates are ordered with the most deeply nested first, so the first match is the one that would be found first:
+    QStringView section = QStringView{key}.first(lastSlash);
+    for(auto& candidate : *candidates) {
+        if(candidate.isTopLevel) {
+            //A section with a leading slash will end up at "/name", never at "name":
+            if(!section.startsWith(u'/')) {
+                return candidate.value;
+            }
+        } else if(section.startsWith(candidate.section) && (section.size() == candidate.section.size() || section[candidate.section.size()] == u'/')) {
+            return candidate.value;
+        }
+    }
+    return {};
+}
+
+void StandardApplicationContext::ConfigurationSnapshot::buildFallbacks()
+{
+    for(auto iter = values.cbegin(); iter != values.cend(); ++iter) {
+        const QString& key = iter.key();
+        qsizetype lastSlash = key.lastIndexOf('/');
+        if(lastSlash < 0) {
+            fallbacksByName[key].push_back({QString{}, true, iter.value()});
+        } else {
+            fallbacksByName[key.sliced(lastSlash + 1)].push_back({key.first(lastSlash), false, iter.value()});
+        }
+    }
+    for(auto& candidates : fallbacksByName) {
+        sortFallbacks(candidates);
+    }
+}
+
+void StandardApplicationContext::ConfigurationSnapshot::updateFallback(const QString &key, const QVariant &value)
+{
+    qsizetype lastSlash = key.lastIndexOf('/');
+    const bool isTopLevel = lastSlash < 0;
+    const QString name = isTopLevel ? key : key.sliced(lastSlash + 1);
+    const QString section = isTopLevel ? QString{} : key.first(lastSlash);
+    auto& candidates = fallbacksByName[name];
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [isTopLevel,&section](const fallback& candidate) {
+        return candidate.isTopLevel == isTopLevel && candidate.section == section;
+    }), candidates.end());
+    if(value.isValid()) {
+        candidates.push_back({section, isTopLevel, value});
+        sortFallbacks(candidates);
+    } else if(candidates.empty()) {
+        fallbacksByName.remove(name);
+    }
+}
+
+void StandardApplicationContext::ConfigurationSnapshot::sortFallbacks(std::vector<fallback> &candidates)
+{
+    std::sort(candidates.begin(), candidates.end(), [](const fallback& left, const fallback& right) {
+        if(left.isTopLevel != right.isTopLevel) {
+            return right.isTopLevel;
+        }
+        return left.section.size() > right.section.size();
+    });
+}
+
+bool StandardApplicationContext::configurationSnapshotEnabled() const
+{
+    return m_configurationSnapshotEnabled;
+}
+
+void StandardApplicationContext::setConfigurationSnapshotEnabled(bool enabled)
+{
+    if(enabled == m_configurationSnapshotEnabled) {
+        return;
+    }
+    m_configurationSnapshotEnabled = enabled;
+    if(enabled) {
+        qCInfo(loggingCategory()) << "Configuration-snapshot has been enabled.";
+    } else {
+        std::atomic_store(&m_configurationSnapshot, std::shared_ptr<const ConfigurationSnapshot>{});
+        //Without a snapshot, memoized results will not be consulted anymore:
+        for(memo_shard& shard : memoizedResults) {
+            QWriteLocker locker{&shard.lock};
+            shard.results.clear();
+        }
+        qCInfo(loggingCategory()) << "Configuration-snapshot has been disabled.";
+    }
+    refreshConfiguration();
+}
+
+std::shared_ptr<const StandardApplicationContext::ConfigurationSnapshot> StandardApplicationContext::configurationSnapshot() const
+{
+    return std::atomic_load(&m_configurationSnapshot);
+}
+
+void StandardApplicationContext::invalidateConditions()
+{
+    conditionGeneration.fetch_add(1, std::memory_order_acq_rel);
+    //The frozen registry contains the results of the Conditions. Thus, it must be rebuilt:
+    if(isFrozen()) {
+        QMutexLocker<QMutex> locker{&mutex};
+        refreeze();
+    }
 }
 
 int StandardApplicationContext::autoRefreshMillis() const
@@ -2183,6 +3259,7 @@ void StandardApplicationContext::setActiveProfiles(const Profiles &profiles)
     if(canChangeActiveProfiles() && *m_activeProfiles != profiles) {
         *m_activeProfiles = profiles;
         initSettingsForActiveProfiles();
+        refreshConfiguration();
         emit activeProfilesChanged(profiles);
     }
 }
@@ -2204,8 +3281,13 @@ QConfigurationWatcher *StandardApplicationContext::watchConfigValue(const QStrin
         qCWarning(loggingCategory()).nospace().noquote() << "Expression '" << expression << "' will not be watched, as auto-refresh has not been enabled";
         return nullptr;
     }
-    return dynamic_cast<QConfigurationWatcher*>(obtainHandleFromApplicationThread([expression,this] {
-        return m_SettingsWatcher->watchConfigValue(getResolver(expression));
+    //The expression is parsed in the calling thread. Only the QConfigurationWatcher needs to be created in the ApplicationContext's thread:
+    auto resolver = getResolver(expression);
+    if(!resolver) {
+        return nullptr;
+    }
+    return dynamic_cast<QConfigurationWatcher*>(obtainHandleFromApplicationThread([resolver,this] {
+        return m_SettingsWatcher->watchConfigValue(resolver);
     }));
 }
 
@@ -2214,13 +3296,9 @@ QVariant StandardApplicationContext::resolveConfigValue(const QString &expressio
     if(detail::PlaceholderResolver::isLiteral(expression)) {
         return expression;
     }
-    detail::PlaceholderResolver* resolver;
-    {
-        QMutexLocker<QMutex> locker{&mutex};
-        resolver = dynamic_cast<detail::PlaceholderResolver*>(obtainHandleFromApplicationThread([this,expression] { return getResolver(expression);}));
-    }
-    if(resolver) {
-        return resolver->resolve(group, resolvedPlaceholders);
+    //The resolverCache can be used from any thread. Thus, there is no need to lock the mutex or to involve the ApplicationContext's thread:
+    if(auto resolver = getResolver(expression)) {
+        return resolveMemoized(resolver, group, resolvedPlaceholders);
     }
     return QVariant{};
 }
@@ -2,7 +2,9 @@
 #include "applicationcontextimplbase.h"
 #include <QSettings>
 #include <QTemporaryFile>
+#include <QTimer>
 #include <QTest>
+#include "registrationslot.h"
 
 
 namespace mcnepp::qtdi::detail {
@@ -47,7 +49,7 @@ private slots:
     }
 
     void testResolveLiteral() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("Hello, world!", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("Hello, world!", configResolver.get());
         QVERIFY(resolver);
         QVERIFY(!resolver->hasPlaceholders());
         QCOMPARE(resolver->resolve(), "Hello, world!");
@@ -55,7 +57,7 @@ private slots:
     }
 
     void testResolveSimplePlaceholder() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
         QVERIFY(resolver);
         QVERIFY(resolver->hasPlaceholders());
         settings->setValue("sayit", "Hello, world!");
@@ -64,7 +66,7 @@ private slots:
     }
 
     void testResolvePlaceholderInSection() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${test/sayit}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${test/sayit}", configResolver.get());
         QVERIFY(resolver);
         settings->setValue("test/sayit", "Hello, world!");
         QCOMPARE(resolver->resolve(), "Hello, world!");
@@ -72,7 +74,7 @@ private slots:
     }
 
     void testResolvePlaceholderInConfigSection() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
         QVERIFY(resolver);
         settings->setValue("test/sayit", "Hello, world!");
         QCOMPARE(resolver->resolve("test"), "Hello, world!");
@@ -81,7 +83,7 @@ private slots:
 
 
     void testResolvePlaceholderInSectionRecursive() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${*/tests/test/sayit}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${*/tests/test/sayit}", configResolver.get());
         QVERIFY(resolver);
         settings->setValue("sayit", "Hello, world!");
         QCOMPARE(resolver->resolve(), "Hello, world!");
@@ -90,7 +92,7 @@ private slots:
     }
 
     void testResolveEmbeddedPlaceholder() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
         QVERIFY(resolver);
         settings->setValue("sayit", "world");
         QCOMPARE(resolver->resolve(), "Hello, world!");
@@ -98,7 +100,7 @@ private slots:
     }
 
     void testResolveFromPrivateProperty() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
         QVERIFY(resolver);
         QVariantMap cfg;
         cfg.insert("sayit", "world");
@@ -108,7 +110,7 @@ private slots:
 
 
     void testResolveRecursiveFromPrivateProperty() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
         QVERIFY(resolver);
 
         settings->setValue("text", "world");
@@ -121,30 +123,109 @@ private slots:
     }
 
     void testResolveGroup() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("Hello, ${sayit}!", configResolver.get());
         settings->setValue("sub/sayit", "world");
         QVariantMap cfg;
         cfg.insert("group", "sub");
         QCOMPARE(resolver->resolve("${group}", cfg), "Hello, world!");
     }
 
+    void testResolveGroupOnlyOnce() {
+        auto resolver = PlaceholderResolver::parse("${greeting}, ${name}!", configResolver.get());
+        QVERIFY(resolver);
+        settings->setValue("sub/greeting", "Hello");
+        settings->setValue("sub/name", "world");
+        QVariantMap cfg;
+        cfg.insert("group", "sub");
+        QCOMPARE(resolver->resolve("${group}", cfg), "Hello, world!");
+        QCOMPARE(configResolver->lookupKeys.count("group"), 1);
+        QVERIFY(configResolver->lookupKeys.contains("sub/greeting"));
+        QVERIFY(configResolver->lookupKeys.contains("sub/name"));
+    }
+
+    void testConfigureServiceLooksUpEachKeyOnce() {
+        settings->setValue("group", "sub");
+        settings->setValue("sub/interval", 4711);
+        settings->setValue("sub/name", "timer");
+        auto reg = configResolver->registerService(service<QTimer>() << withGroup("${group}") << propValue("interval", "${interval}") << propValue("objectName", "${name}-${interval}") << propValue("singleShot", "${singleShot:true}"), "timer");
+        RegistrationSlot<QTimer> slot{reg, this};
+        QVERIFY(configResolver->publish());
+        QCOMPARE(slot->interval(), 4711);
+        QCOMPARE(slot->objectName(), "timer-4711");
+        QVERIFY(slot->isSingleShot());
+        //The group has been resolved once for all properties, and every distinct key has been looked up once:
+        QCOMPARE(configResolver->lookupKeys.count("group"), 1);
+        QCOMPARE(configResolver->lookupKeys.count("sub/interval"), 1);
+        QCOMPARE(configResolver->lookupKeys.count("sub/name"), 1);
+        QCOMPARE(configResolver->lookupKeys.count("sub/singleShot"), 1);
+    }
+
+    void testGroupIsResolvedBeforeProperties() {
+        settings->setValue("sub/interval", 4711);
+        //The group is resolved before the properties. It may refer to a private property, though:
+        auto reg = configResolver->registerService(service<QTimer>() << withGroup("${section}") << placeholderValue("section", "sub") << propValue("interval", "${interval}"), "timer");
+        RegistrationSlot<QTimer> slot{reg, this};
+        QVERIFY(configResolver->publish());
+        QCOMPARE(slot->interval(), 4711);
+    }
+
+
+    void testResolveSinglePlaceholderKeepsType() {
+        auto resolver = PlaceholderResolver::parse("${amount}", configResolver.get());
+        QVERIFY(resolver);
+        QVariantMap cfg;
+        cfg.insert("amount", 42);
+        QVariant resolved = resolver->resolve("", cfg);
+        QCOMPARE(resolved.typeId(), QMetaType::Int);
+        QCOMPARE(resolved, 42);
+    }
+
+    void testResolveAdjacentPlaceholders() {
+        auto resolver = PlaceholderResolver::parse("${greeting}, ${name}${punctuation}", configResolver.get());
+        QVERIFY(resolver);
+        settings->setValue("greeting", "Hello");
+        settings->setValue("name", "world");
+        settings->setValue("punctuation", "!");
+        QCOMPARE(resolver->resolve(), "Hello, world!");
+        QStringList expected{"greeting", "name", "punctuation"};
+        QCOMPARE(configResolver->lookupKeys, expected);
+    }
+
+    void testResolveDoesNotDetachUnchangedPlaceholders() {
+        auto resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
+        QVERIFY(resolver);
+        settings->setValue("sayit", "Hello, world!");
+        QVariantMap cfg;
+        QCOMPARE(resolver->resolve("", cfg), "Hello, world!");
+        QVariantMap shared{cfg};
+        QCOMPARE(resolver->resolve("", cfg), "Hello, world!");
+        QVERIFY(cfg.isSharedWith(shared));
+    }
+
+    void testUnresolvablePlaceholderLeavesNoEntry() {
+        auto resolver = PlaceholderResolver::parse("${sayit}", configResolver.get());
+        QVERIFY(resolver);
+        QVariantMap cfg;
+        QVERIFY(!resolver->resolve("", cfg).isValid());
+        QVERIFY(cfg.isEmpty());
+    }
 
     void testResolveDefaultValue() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${sayit:Hello, world!}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${sayit:Hello, world!}", configResolver.get());
         QVERIFY(resolver);
         QCOMPARE(resolver->resolve(), "Hello, world!");
         QCOMPARE(configResolver->lookupKeys, QStringList{"sayit"});
     }
 
     void testEscapeDollar() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("price: ${amount}\\$", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("price: ${amount}\\$", configResolver.get());
         QVERIFY(resolver);
         settings->setValue("amount", 42);
         QCOMPARE(resolver->resolve(), "price: 42$");
     }
 
     void testEscapeOpeningBracket() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("$\\{placeholder}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("$\\{placeholder}", configResolver.get());
         QVERIFY(resolver);
         QVERIFY(!resolver->hasPlaceholders());
         QCOMPARE(resolver->resolve(), "${placeholder}");
@@ -152,21 +233,41 @@ private slots:
 
 
     void testUnbalanced() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${sayit", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${sayit", configResolver.get());
         QVERIFY(!resolver);
     }
 
     void testInvalidDollarInPlaceholder() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${A dollar$}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${A dollar$}", configResolver.get());
         QVERIFY(!resolver);
     }
 
     void testInvalidWildcardInPlaceholder() {
-        PlaceholderResolver* resolver = PlaceholderResolver::parse("${*A dollar}", configResolver.get());
+        auto resolver = PlaceholderResolver::parse("${*A dollar}", configResolver.get());
         QVERIFY(!resolver);
     }
 
 
+    void testParseLargeExpression() {
+        QString expression;
+        QString expected;
+        for(int n = 0; n < 1000; ++n) {
+            expression += QString{"Entry %1 costs ${price%1:%1}\\$, "}.arg(n);
+            expected += QString{"Entry %1 costs %1$, "}.arg(n);
+        }
+        auto resolver = PlaceholderResolver::parse(expression, configResolver.get());
+        QVERIFY(resolver);
+        QVERIFY(resolver->hasPlaceholder("price999"));
+        QCOMPARE(resolver->resolve(), expected);
+    }
+
+    void testIsLiteral() {
+        QVERIFY(PlaceholderResolver::isLiteral(""));
+        QVERIFY(PlaceholderResolver::isLiteral("price: 42$"));
+        QVERIFY(PlaceholderResolver::isLiteral("$$ {}"));
+        QVERIFY(!PlaceholderResolver::isLiteral("$${amount}"));
+        QVERIFY(!PlaceholderResolver::isLiteral("${amount}"));
+    }
 
 private:
     std::unique_ptr<QTemporaryFile> tempFile;
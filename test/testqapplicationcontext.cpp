@@ -1,6 +1,8 @@
 #include <QTest>
 #include <QSettings>
 #include <QTemporaryFile>
+#include <QTemporaryDir>
+#include <QFileInfo>
 #include <QPromise>
 #include <QSemaphore>
 #include <QFuture>
@@ -8,6 +10,8 @@
 #include "appcontexttestclasses.h"
 #include "applicationcontextimplbase.h"
 #include "standardapplicationcontext.h"
+#include "compiledsettings.h"
+#include "qjsonconfigurationsource.h"
 #include "registrationslot.h"
 #include "qtestcase.h"
 
@@ -132,6 +136,50 @@ public:
 };
 
 
+//A QConfigurationSource that counts how often each key has been looked up:
+class CountingConfigurationSource : public QConfigurationSource {
+public:
+    explicit CountingConfigurationSource(const QVariantMap& entries, QObject* parent = nullptr) : QConfigurationSource{parent},
+        m_entries{entries} {
+    }
+
+    QVariant value(const QString& key) const override {
+        ++m_lookups[key];
+        return m_entries.value(key);
+    }
+
+    QStringList allKeys() const override {
+        return m_entries.keys();
+    }
+
+    QString fileName() const override {
+        return "counting";
+    }
+
+    bool hasFile() const override {
+        return false;
+    }
+
+    void refresh() override {
+    }
+
+    QConfigurationSource* createForProfile(const QString&, QObject*) const override {
+        return nullptr;
+    }
+
+    void setValue(const QString& key, const QVariant& value) {
+        m_entries.insert(key, value);
+    }
+
+    int lookups(const QString& key) const {
+        return m_lookups.value(key);
+    }
+
+private:
+    QVariantMap m_entries;
+    mutable QHash<QString,int> m_lookups;
+};
+
 class ApplicationContextTest
  : public QObject {
     Q_OBJECT
@@ -437,6 +485,442 @@ private slots:
 
     }
 
+    void testConfigurationSnapshot() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        configuration->setValue("sub/two", "Zwei");
+        configuration->setValue("sub/one", "Eins");
+        configuration->setValue("subway", "U-Bahn");
+        configuration->setValue("root", "Wurzel");
+        QVERIFY(!appContext->configurationSnapshotEnabled());
+        appContext->setConfigurationSnapshotEnabled(true);
+        QVERIFY(appContext->configurationSnapshotEnabled());
+        context->registerObject(configuration.get());
+        QStringList expectedKeys{"sub/one", "sub/two"};
+        QCOMPARE(context->configurationKeys("sub"), expectedKeys);
+        QCOMPARE(context->getConfigurationValue("root"), "Wurzel");
+        QCOMPARE(context->getConfigurationValue("sub/root", true), "Wurzel");
+        QCOMPARE(context->getConfigurationValue("sub/deeper/root", true), "Wurzel");
+        //Second lookup yields the same entry:
+        QCOMPARE(context->getConfigurationValue("sub/deeper/root", true), "Wurzel");
+        QVERIFY(!context->getConfigurationValue("sub/deeper/nothing", true).isValid());
+        QCOMPARE(context->getConfigurationValue("sub/one"), "Eins");
+        QCOMPARE(context->getConfigurationValue("sub/deeper/one", true), "Eins");
+        //'sub' is a prefix of 'subway', but not a parent-section:
+        QVERIFY(!context->getConfigurationValue("subway/one", true).isValid());
+
+        configuration->setValue("root", "Baum");
+        //The modification is not visible before the snapshot has been refreshed:
+        QCOMPARE(context->getConfigurationValue("root"), "Wurzel");
+        QCOMPARE(context->getConfigurationValue("sub/deeper/root", true), "Wurzel");
+        appContext->refreshConfiguration();
+        QCOMPARE(context->getConfigurationValue("root"), "Baum");
+        QCOMPARE(context->getConfigurationValue("sub/deeper/root", true), "Baum");
+    }
+
+    void testSortedKeyIndex() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        appContext->setConfigurationSnapshotEnabled(true);
+        configuration->setValue("sub/two", "Zwei");
+        configuration->setValue("sub/one", "Eins");
+        configuration->setValue("sub/deeper/three", "Drei");
+        //'-' precedes '/', whereas 'w' follows it. Thus, the keys of 'sub' are enclosed by keys that merely start with 'sub':
+        configuration->setValue("sub-total", 42);
+        configuration->setValue("subway/line", "U1");
+        context->registerObject(configuration.get());
+        QStringList expectedKeys{"sub/deeper/three", "sub/one", "sub/two"};
+        QCOMPARE(context->configurationKeys("sub"), expectedKeys);
+        QCOMPARE(context->configurationKeys("sub/deeper"), QStringList{"sub/deeper/three"});
+        QCOMPARE(context->configurationKeys("subway"), QStringList{"subway/line"});
+        QVERIFY(context->configurationKeys("su").isEmpty());
+        QStringList rootKeys = context->configurationKeys();
+        QVERIFY(std::is_sorted(rootKeys.begin(), rootKeys.end()));
+        QVERIFY(rootKeys.contains("sub-total"));
+
+        configuration->setValue("sub/four", "Vier");
+        appContext->refreshConfiguration();
+        expectedKeys.insert(1, "sub/four");
+        QCOMPARE(context->configurationKeys("sub"), expectedKeys);
+    }
+
+    void testAutowiredPropertiesFromConfigurationSnapshot() {
+        static_cast<StandardApplicationContext*>(context.get())->setConfigurationSnapshotEnabled(true);
+        configuration->setValue("timer/interval", 4711);
+        //Not a key of the section 'timer':
+        configuration->setValue("timerX/singleShot", true);
+        context->registerObject(configuration.get());
+        auto regTimer = context->registerService(service<QTimer>() << withAutowire, "timer");
+
+        QVERIFY(context->publish());
+        RegistrationSlot<QTimer> timerSlot{regTimer, this};
+        QVERIFY(timerSlot);
+        QCOMPARE(timerSlot->interval(), 4711);
+        QVERIFY(!timerSlot->isSingleShot());
+    }
+
+    void testEnableConfigurationSnapshotAfterRegistration() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        configuration->setValue("root", "Wurzel");
+        context->registerObject(configuration.get());
+        appContext->setConfigurationSnapshotEnabled(true);
+        configuration->setValue("root", "Baum");
+        //The snapshot has been built when it was enabled:
+        QCOMPARE(context->getConfigurationValue("root"), "Wurzel");
+        appContext->setConfigurationSnapshotEnabled(false);
+        QVERIFY(!appContext->configurationSnapshotEnabled());
+        //Without the snapshot, the QSettings will be queried directly:
+        QCOMPARE(context->getConfigurationValue("root"), "Baum");
+    }
+
+    void testCompiledIniFormat() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("compiled.ini");
+        //The file must not be written using a QSettings, as QSettings shares the parsed data of a file among all instances:
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+            file.write("root=Wurzel\n");
+            file.write("; A comment\n");
+            file.write("list=1, 2 ,3\n");
+            file.write("[sub]\n");
+            file.write("one=Eins ; Another comment\n");
+            file.write("quoted=\"Eins, zwei\"\n");
+            file.write("escaped=line\\none\n");
+            file.write("[%General]\n");
+            file.write("section%2Fkey=value\n");
+        }
+        QSettings compiled{path, compiledIniFormat()};
+        QCOMPARE(compiled.value("root"), "Wurzel");
+        QCOMPARE(compiled.value("list"), QStringList({"1", "2", "3"}));
+        QCOMPARE(compiled.value("sub/one"), "Eins");
+        QCOMPARE(compiled.value("sub/quoted"), "Eins, zwei");
+        QCOMPARE(compiled.value("sub/escaped"), "line\none");
+        QCOMPARE(compiled.value("General/section/key"), "value");
+        QVERIFY(QFile::exists(path + ".qtdicache"));
+
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+            file.write("root=Baum\n");
+        }
+        //The compiled image is outdated, thus the INI-file will be parsed again:
+        QSettings recompiled{path, compiledIniFormat()};
+        QCOMPARE(recompiled.value("root"), "Baum");
+        QCOMPARE(recompiled.allKeys().size(), 1);
+    }
+
+    void testCompiledIniFormatReadsImage() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("compiled.ini");
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+            file.write("root=Wurzel\n");
+        }
+        {
+            QSettings compiled{path, compiledIniFormat()};
+            QCOMPARE(compiled.value("root"), "Wurzel");
+        }
+        //QSettings shares the data per path. Thus, copy the image and a source of the same size and modification-time to a new path:
+        QString copiedPath = dir.filePath("copied.ini");
+        QVERIFY(QFile::copy(path + ".qtdicache", copiedPath + ".qtdicache"));
+        {
+            QFile file{copiedPath};
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+            file.write("root=Baumxx\n");
+            file.close();
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QFileInfo{path}.lastModified(), QFileDevice::FileModificationTime));
+        }
+        //The image is considered up-to-date, thus its content will be used instead of the INI-file's:
+        QSettings fromImage{copiedPath, compiledIniFormat()};
+        QCOMPARE(fromImage.value("root"), "Wurzel");
+    }
+
+    void testCompiledIniFormatMatchesIniFormat() {
+        QTemporaryDir dir;
+        QByteArray content =
+            "; A comment-line\n"
+            "root = Wurzel ; A trailing comment\n"
+            "continued=first \\\n  second\n"
+            "list=1, 2 ,3\n"
+            "quoted=\"Eins, zwei\", drei\n"
+            "semicolon=\"a;b\"\n"
+            "escapes=tab\\there \\x41\\101 \\\"quoted\\\"\n"
+            "atAt=@@literal\n"
+            "bytes=@ByteArray(raw)\n"
+            "size=@Size(3 4)\n"
+            "point=@Point(1 2)\n"
+            "rect=@Rect(1 2 3 4)\n"
+            "[sub]\n"
+            "key%20with%20space=value\n"
+            "nested\\key=deep\n"
+            "[General]\n"
+            "top=level\n"
+            "[%General]\n"
+            "key=value\n";
+        //Let QSettings::IniFormat write values that it escapes, such as the binary data of @Variant(...):
+        {
+            QSettings writer{dir.filePath("written.ini"), QSettings::IniFormat};
+            writer.setValue("written/date", QDate{2024, 2, 29});
+            writer.setValue("written/list", QStringList{" leading", "a, b", "trailing "});
+            writer.setValue("written/control", QString{"bell\a and tab\t"});
+        }
+        {
+            QFile written{dir.filePath("written.ini")};
+            QVERIFY(written.open(QIODevice::ReadOnly));
+            content += written.readAll();
+        }
+        //QSettings shares the parsed data per path. Thus, each format reads its own copy of the content:
+        for(const char* name : {"plain.ini", "compiled.ini"}) {
+            QFile file{dir.filePath(name)};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(content);
+        }
+        QSettings plain{dir.filePath("plain.ini"), QSettings::IniFormat};
+        QSettings compiled{dir.filePath("compiled.ini"), compiledIniFormat()};
+        QStringList keys = plain.allKeys();
+        QStringList compiledKeys = compiled.allKeys();
+        keys.sort();
+        compiledKeys.sort();
+        QCOMPARE(compiledKeys, keys);
+        for(const QString& key : std::as_const(keys)) {
+            QCOMPARE(compiled.value(key), plain.value(key));
+        }
+        QCOMPARE(compiled.value("General/key"), "value");
+        QCOMPARE(compiled.value("written/date"), QDate(2024, 2, 29));
+    }
+
+    void testCompiledIniConfigurationSource() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("application.ini");
+        QByteArray content =
+            "root=Wurzel\n"
+            "list=1, 2 ,3\n"
+            "[sub]\n"
+            "one=Eins\n"
+            "size=@Size(3 4)\n"
+            "[%general]\n"
+            "key=value\n";
+        for(const QString& name : {path, dir.filePath("plain.ini")}) {
+            QFile file{name};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(content);
+        }
+        QCompiledIniConfigurationSource source{path};
+        QVERIFY(QFile::exists(path + ".qtdicache"));
+        QSettings plain{dir.filePath("plain.ini"), QSettings::IniFormat};
+        QStringList keys = plain.allKeys();
+        keys.sort();
+        QCOMPARE(source.allKeys(), keys);
+        for(const QString& key : std::as_const(keys)) {
+            QCOMPARE(source.value(key), plain.value(key));
+        }
+        QCOMPARE(source.value("general/key"), "value");
+        QVERIFY(!source.value("sub").isValid());
+        QVERIFY(!source.value("zzz").isValid());
+
+        //Another source maps the existing image:
+        QCompiledIniConfigurationSource fromImage{path};
+        QCOMPARE(fromImage.value("sub/one"), "Eins");
+
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("root=Baum\n");
+        }
+        source.refresh();
+        QCOMPARE(source.value("root"), "Baum");
+        QCOMPARE(source.allKeys(), QStringList{"root"});
+        //The image is replaced atomically, thus the previous mapping is not affected:
+        QCOMPARE(fromImage.value("sub/one"), "Eins");
+
+        context->registerObject(new QCompiledIniConfigurationSource{path, context.get()});
+        QCOMPARE(context->getConfigurationValue("root"), "Baum");
+    }
+
+    void testJsonConfigurationSource() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("application.json");
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(R"({"timerInterval": 4711, "sub": {"one": "Eins", "list": [1, 2]}})");
+        }
+        context->registerObject(new QJsonConfigurationSource{path, context.get()});
+        QCOMPARE(context->getConfigurationValue("timerInterval"), 4711);
+        QCOMPARE(context->getConfigurationValue("sub/one"), "Eins");
+        QCOMPARE(context->getConfigurationValue("sub/list"), (QVariantList{1, 2}));
+        QCOMPARE(context->configurationKeys("sub").size(), 2);
+
+        auto reg = context->registerService(service<QTimer>() << propValue("interval", "${timerInterval}"));
+        QVERIFY(context->publish());
+        RegistrationSlot<QTimer> slot{reg, this};
+        QCOMPARE(slot->interval(), 4711);
+    }
+
+    void testJsonConfigurationSourceRefresh() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("application.json");
+        auto writeFile = [&path](const char* content) {
+            QFile file{path};
+            return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(content) > 0;
+        };
+        QVERIFY(writeFile(R"({"name": "readme"})"));
+        QJsonConfigurationSource source{path};
+        QCOMPARE(source.value("name"), "readme");
+
+        //The size of the file changes, thus it will be parsed again:
+        QVERIFY(writeFile(R"({"name": "readme", "suffix": "txt"})"));
+        source.refresh();
+        QCOMPARE(source.value("suffix"), "txt");
+        QCOMPARE(source.allKeys().size(), 2);
+
+        //A file that cannot be parsed shall not affect the previous entries:
+        QVERIFY(writeFile(R"({"name": "broken")"));
+        source.refresh();
+        QCOMPARE(source.value("name"), "readme");
+        QCOMPARE(source.value("suffix"), "txt");
+
+        QVERIFY(writeFile(R"([1, 2, 3])"));
+        source.refresh();
+        QCOMPARE(source.value("name"), "readme");
+
+        //The file that could not be parsed is not parsed again before it has been modified:
+        QDateTime brokenModified = QFileInfo{path}.lastModified();
+        QVERIFY(writeFile(R"({"a": 12})"));
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(brokenModified, QFileDevice::FileModificationTime));
+        }
+        source.refresh();
+        QVERIFY(!source.value("a").isValid());
+
+        QVERIFY(writeFile(R"({"name": "fixed"})"));
+        source.refresh();
+        QCOMPARE(source.value("name"), "fixed");
+    }
+
+    void testJsonConfigurationSourceForProfile() {
+        QTemporaryDir dir;
+        {
+            QFile file{dir.filePath("application.json")};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(R"({"qtdi": {"activeProfiles": "test", "enableProfileSpecificSettings": true}, "timer": {"interval": 5000, "singleShot": true}})");
+        }
+        {
+            QFile file{dir.filePath("application-test.json")};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(R"({"timer": {"interval": 4711}})");
+        }
+        context->registerObject(new QJsonConfigurationSource{dir.filePath("application.json"), context.get()});
+        QCOMPARE(context->activeProfiles(), Profiles{"test"});
+        QCOMPARE(context->getConfigurationValue("timer/interval"), 4711);
+
+        auto timerReg = context->registerService(service<QTimer>() << withAutowire, "timer");
+        RegistrationSlot<QTimer> timerSlot{timerReg, this};
+        QVERIFY(context->publish());
+        QCOMPARE(timerSlot->interval(), 4711);
+        QVERIFY(timerSlot->isSingleShot());
+    }
+
+    void testJsonConfigurationSourceAutoRefresh() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("application.json");
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(R"({"qtdi": {"enableAutoRefresh": true, "autoRefreshMillis": 100}, "name": "readme"})");
+        }
+        context->registerObject(new QJsonConfigurationSource{path, context.get()});
+        QVERIFY(context->autoRefreshEnabled());
+        QCOMPARE(static_cast<StandardApplicationContext*>(context.get())->autoRefreshMillis(), 100);
+
+        QConfigurationWatcher* watcher = context->watchConfigValue("${name}");
+        QVERIFY(watcher);
+        QVariant watchedValue;
+        connect(watcher, &QConfigurationWatcher::currentValueChanged, this, [&watchedValue](const QVariant& currentValue) {watchedValue=currentValue;});
+        {
+            QFile file{path};
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            file.write(R"({"qtdi": {"enableAutoRefresh": true, "autoRefreshMillis": 100}, "name": "hello, world"})");
+        }
+        QVERIFY(QTest::qWaitFor([&watchedValue] { return watchedValue == "hello, world";}, 1000));
+    }
+
+    void testMemoizedPlaceholderResults() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        appContext->setConfigurationSnapshotEnabled(true);
+        auto source = new CountingConfigurationSource{{{"dbHost", "localhost"}, {"dbPort", 5432}}, context.get()};
+        context->registerObject(source);
+        const int lookups = source->lookups("dbHost");
+        QString first = context->resolveConfigValue("${dbHost}:${dbPort}").toString();
+        QCOMPARE(first, "localhost:5432");
+        QVariantMap resolvedPlaceholders;
+        QString second = context->resolveConfigValue("${dbHost}:${dbPort}", {}, resolvedPlaceholders).toString();
+        //The memoized result has been used without resolving the expression again:
+        QCOMPARE(second.constData(), first.constData());
+        //The memoized result must yield the resolved placeholders, too:
+        QCOMPARE(resolvedPlaceholders["dbHost"], "localhost");
+        QCOMPARE(resolvedPlaceholders["dbPort"].toInt(), 5432);
+        //All lookups have been served by the snapshot:
+        QCOMPARE(source->lookups("dbHost"), lookups);
+
+        source->setValue("unrelated", "value");
+        appContext->refreshConfiguration();
+        QCOMPARE(source->lookups("dbHost"), lookups + 1);
+        //The memoized result has been re-validated against the refreshed snapshot:
+        QCOMPARE(context->resolveConfigValue("${dbHost}:${dbPort}").toString().constData(), first.constData());
+
+        //A result that has not been used since the previous snapshot has been discarded:
+        appContext->refreshConfiguration();
+        appContext->refreshConfiguration();
+        QString resolvedAgain = context->resolveConfigValue("${dbHost}:${dbPort}").toString();
+        QCOMPARE(resolvedAgain, "localhost:5432");
+        QVERIFY(resolvedAgain.constData() != first.constData());
+
+        source->setValue("dbPort", 5433);
+        appContext->refreshConfiguration();
+        QCOMPARE(context->resolveConfigValue("${dbHost}:${dbPort}"), "localhost:5433");
+    }
+
+    void testMemoizedPropertiesOfPrototype() {
+        static_cast<StandardApplicationContext*>(context.get())->setConfigurationSnapshotEnabled(true);
+        auto source = new CountingConfigurationSource{{{"dbHost", "localhost"}}, context.get()};
+        context->registerObject(source);
+        const int lookups = source->lookups("dbHost");
+        auto regProto = context->registerService(prototype<BaseService>() << propValue("foo", "jdbc://${dbHost}"), "base");
+        context->registerService(service<DependentService>(regProto), "dependent1");
+        context->registerService(service<DependentService>(regProto), "dependent2");
+        RegistrationSlot<BaseService> protoSlot{regProto, this};
+        QVERIFY(context->publish());
+        QCOMPARE(protoSlot.invocationCount(), 2);
+        QCOMPARE(protoSlot[0]->foo(), "jdbc://localhost");
+        //The second instance has been configured with the memoized result:
+        QCOMPARE(protoSlot[1]->foo().constData(), protoSlot[0]->foo().constData());
+        QCOMPARE(source->lookups("dbHost"), lookups);
+    }
+
+    void testConfigurationSnapshotContainsEnvironment() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        QString uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        QByteArray envKey = "qtditest." + uuid.toLatin1();
+        QString key = "qtditest/" + uuid;
+        qputenv(envKey, "value from the environment");
+        appContext->setConfigurationSnapshotEnabled(true);
+        context->registerObject(configuration.get());
+        QCOMPARE(context->getConfigurationValue(key), "value from the environment");
+        QCOMPARE(context->getConfigurationValue("qtditest." + uuid), "value from the environment");
+        QVERIFY(context->configurationKeys("qtditest").contains(key));
+
+        qputenv(envKey, "modified value");
+        //The modification is not visible before the snapshot has been refreshed:
+        QCOMPARE(context->getConfigurationValue(key), "value from the environment");
+        appContext->refreshConfiguration();
+        QCOMPARE(context->getConfigurationValue(key), "modified value");
+        qunsetenv(envKey);
+    }
+
 
     void testWithPlaceholderProperty() {
         PostProcessor postProcessor;
@@ -557,6 +1041,81 @@ private slots:
         QVERIFY(QTest::qWaitFor([&slot] { return slot->interval() == 999;}, 1000));
     }
 
+    void testAutoRefreshChecksOnlyDependentWatchers() {
+        configuration->setValue("name", "readme");
+        configuration->setValue("qtdi/enableAutoRefresh", true);
+        configuration->setValue("qtdi/autoRefreshMillis", 100);
+        context->registerObject(configuration.get());
+        QVERIFY(context.get()->autoRefreshEnabled());
+
+        QConfigurationWatcher* watcher = context->watchConfigValue("${name}");
+        QVERIFY(watcher);
+        QConfigurationWatcher* unresolvableWatcher = context->watchConfigValue("${unresolvable}");
+        QVERIFY(unresolvableWatcher);
+        QVariant watchedValue;
+        connect(watcher, &QConfigurationWatcher::currentValueChanged, this, [&watchedValue](const QVariant& currentValue) {watchedValue=currentValue;});
+        int errors = 0;
+        connect(unresolvableWatcher, &QConfigurationWatcher::errorOccurred, this, [&errors] { ++errors;});
+
+        configuration->setValue("name", "hello");
+        QVERIFY(QTest::qWaitFor([&watchedValue] { return watchedValue == "hello";}, 1000));
+        //The unresolvable expression does not depend on the changed key, thus it shall not have been checked again:
+        QCOMPARE(errors, 0);
+    }
+
+    void testAutoRefreshPropertyWithPrivatePlaceholder() {
+        configuration->setValue("dbHost", "localhost");
+        configuration->setValue("qtdi/enableAutoRefresh", true);
+        configuration->setValue("qtdi/autoRefreshMillis", 100);
+        context->registerObject(configuration.get());
+        //The watched property depends on 'dbHost' only indirectly, via the private placeholder 'host':
+        auto reg = context->registerService(service<QTimer>() << placeholderValue("host", "${dbHost}") << autoRefresh("objectName", "${host}"), "timer");
+        RegistrationSlot<QTimer> slot{reg, this};
+        QVERIFY(context->publish());
+        QCOMPARE(slot->objectName(), "localhost");
+
+        configuration->setValue("dbHost", "remotehost");
+        QVERIFY(QTest::qWaitFor([&slot] { return slot->objectName() == "remotehost";}, 1000));
+    }
+
+    void testAutoRefreshWatchesEnvironment() {
+        QString uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        QByteArray envKey = "qtditest." + uuid.toLatin1();
+        qputenv(envKey, "from the environment");
+        configuration->setValue("qtdi/enableAutoRefresh", true);
+        configuration->setValue("qtdi/autoRefreshMillis", 100);
+        context->registerObject(configuration.get());
+        QConfigurationWatcher* watcher = context->watchConfigValue("${qtditest/" + uuid + "}");
+        QVERIFY(watcher);
+        QCOMPARE(watcher->currentValue(), "from the environment");
+
+        //No configuration-entry changes, but the environment does:
+        qputenv(envKey, "modified");
+        QVERIFY(QTest::qWaitFor([watcher] { return watcher->currentValue() == "modified";}, 1000));
+        qunsetenv(envKey);
+    }
+
+    void testAutoRefreshUpdatesSnapshotIncrementally() {
+        static_cast<StandardApplicationContext*>(context.get())->setConfigurationSnapshotEnabled(true);
+        auto source = new CountingConfigurationSource{{{"qtdi/enableAutoRefresh", true}, {"qtdi/autoRefreshMillis", 100}, {"dbHost", "localhost"}, {"dbPort", 5432}}, context.get()};
+        context->registerObject(source);
+        QConfigurationWatcher* watcher = context->watchConfigValue("${dbPort}");
+        QVERIFY(watcher);
+        //The first refresh reports all entries of the newly watched source as changed:
+        QVERIFY(QTest::qWaitFor([source] { return source->lookups("dbHost") > 1;}, 1000));
+
+        QString first = context->resolveConfigValue("${dbHost}:${dbPort}").toString();
+        QTest::qWait(350);
+        //As long as no entry changes, the snapshot is kept. Thus, the memoized result has not been discarded:
+        QCOMPARE(context->resolveConfigValue("${dbHost}:${dbPort}").toString().constData(), first.constData());
+
+        source->setValue("dbPort", 5433);
+        QVERIFY(QTest::qWaitFor([watcher] { return watcher->currentValue() == 5433;}, 1000));
+        QCOMPARE(context->getConfigurationValue("dbPort"), 5433);
+        //Each refresh compares all entries. Only the changed entry has been looked up once more for the snapshot:
+        QCOMPARE(source->lookups("dbPort"), source->lookups("dbHost") + 1);
+    }
+
     void testResolveConfigValueInThread() {
         configuration->setValue("name", "readme");
         configuration->setValue("suffix", "txt");
@@ -572,6 +1131,19 @@ private slots:
 
     }
 
+    void testResolveConfigValueInThreadWithoutEventLoop() {
+        configuration->setValue("name", "readme");
+        context->registerObject(configuration.get());
+        QVariant resolvedValue;
+        QScopedPointer<QThread> thread{QThread::create([&resolvedValue, this] {
+            resolvedValue = context->resolveConfigValue("${name}.${suffix:doc}");
+        })};
+        thread->start();
+        //Block the main-thread, so that no events will be processed while the expression is being resolved:
+        QVERIFY(thread->wait(1000));
+        QCOMPARE(resolvedValue.toString(), "readme.doc");
+    }
+
     void testWatchConfigurationFileChange() {
         QFile file{"testapplicationtext.ini"};
         QVERIFY(file.open(QIODeviceBase::WriteOnly | QIODeviceBase::Text | QIODeviceBase::Truncate));
@@ -1681,6 +2253,37 @@ void testWatchConfigurationFileChangeWithError() {
         QCOMPARE(srv->address(), Address{"127.0.0.1"});
     }
 
+    void testConvertedValueIsCached() {
+        configuration->setValue("host", "localhost");
+        context->registerObject(configuration.get());
+        int conversions = 0;
+        auto countingConverter = [&conversions](const QString& str) { ++conversions; return addressConverter(str); };
+        auto regProto = context->registerService(prototype<DependentService>(injectIfPresent<Interface1>()) << resolveProp(&DependentService::setAddress, "${host}", countingConverter), "proto");
+        context->registerService(service<DependentServiceLevel2>(regProto), "dep1");
+        context->registerService(service<DependentServiceLevel2>(regProto), "dep2");
+        QVERIFY(context->publish());
+        RegistrationSlot<DependentService> protoSlot{regProto, this};
+        QCOMPARE(protoSlot.size(), 2);
+        QCOMPARE(protoSlot.last()->address(), Address{"127.0.0.1"});
+        //The unchanged value has been converted only once:
+        QCOMPARE(conversions, 1);
+    }
+
+    void testConvertedPointerIsNotShared() {
+        configuration->setValue("interval", 4711);
+        context->registerObject(configuration.get());
+        auto timerConverter = [this](const QString& str) { auto timer = new QTimer{this}; timer->setInterval(str.toInt()); return timer; };
+        auto regProto = context->registerService(prototype<BaseService>() << resolveProp(&BaseService::setTimer, "${interval}", timerConverter), "proto");
+        context->registerService(service<DependentService>(regProto), "dep1");
+        context->registerService(service<DependentService>(regProto), "dep2");
+        QVERIFY(context->publish());
+        RegistrationSlot<BaseService> protoSlot{regProto, this};
+        QCOMPARE(protoSlot.size(), 2);
+        QCOMPARE(protoSlot[0]->timer()->interval(), 4711);
+        //Every instance of the prototype must receive its own converted object:
+        QVERIFY(protoSlot[0]->timer() != protoSlot[1]->timer());
+    }
+
     void testAutoRefreshPropertyOfNonStandardTypeWithCustomConverter() {
         QFile file{"testapplicationtext.ini"};
         QVERIFY(file.open(QIODeviceBase::WriteOnly | QIODeviceBase::Text | QIODeviceBase::Truncate));
@@ -2263,6 +2866,30 @@ void testWatchConfigurationFileChangeWithError() {
 
     }
 
+    void testTypeIndexAfterRevertedBatch() {
+        context->registerService(service<Interface1,BaseService>(), "base");
+        RegistrationBatch batch;
+        batch.add(service<QTimer>(), "timer").add(service<Interface1,BaseService2>(), "base");
+        QVERIFY(context->registerServices(batch).isEmpty());
+        //The reverted registration must have been removed from the index of types:
+        QVERIFY(context->getRegistration<QTimer>().registeredServices().isEmpty());
+        QCOMPARE(context->getRegistration<Interface1>().registeredServices().size(), 1);
+        auto timerReg = context->registerService(service<QTimer>(), "timer");
+        auto timers = context->getRegistration<QTimer>().registeredServices();
+        QCOMPARE(timers.size(), 1);
+        QCOMPARE(timers[0], timerReg);
+    }
+
+    void testMetaObjectIndexDetectsSameObject() {
+        QTimer timer;
+        auto reg = context->registerObject(&timer, "timer");
+        QVERIFY(reg);
+        //An anonymous registration of the same object yields the existing registration:
+        QCOMPARE(context->registerObject(&timer), reg);
+        //Registering the same object under another name is a conflict:
+        QVERIFY(!context->registerObject(&timer, "anotherTimer"));
+    }
+
     void testAdvertiseAdditionalInterface() {
         auto reg = context->registerService(service<Interface1,BaseService>().advertiseAs<TimerAware>());
         auto reg2 = context->registerService(service<BaseService>().advertiseAs<Interface1,TimerAware>());
@@ -2338,6 +2965,18 @@ void testWatchConfigurationFileChangeWithError() {
         QCOMPARE(context->getRegistration("Jill"), reg);
     }
 
+    void testGetRegistrationByStringView() {
+        auto reg = context->registerService(service<Interface1,BaseService>(), "base");
+        auto reg2 = context->registerService(service<Interface1,BaseService2>(), QString::fromUtf16(u"b\u00e4se"));
+        QVERIFY(reg.registerAlias("Hugo"));
+        QCOMPARE(context->getRegistration(QLatin1StringView{"base"}), reg);
+        QCOMPARE(context->getRegistration(u"base"), reg);
+        QCOMPARE(context->getRegistration(QStringView{u"Hugo"}), reg);
+        QCOMPARE(context->getRegistration(QLatin1StringView{"b\xe4se"}), reg2);
+        QCOMPARE(context->getRegistration(QUtf8StringView{"b\xc3\xa4se"}), reg2);
+        QVERIFY(!context->getRegistration(QLatin1StringView{"bas"}));
+    }
+
 
     void testRegisterTwiceDifferentImpl() {
         auto reg = context->registerService(service<Interface1,BaseService>());
@@ -2758,6 +3397,24 @@ void testWatchConfigurationFileChangeWithError() {
 
     }
 
+    void testTransitiveCyclicDependency() {
+        auto regA = context->registerService(service<BaseService>(inject<CyclicDependency>("c1")), "a");
+        QVERIFY(regA);
+        auto regC2 = context->registerService(service<CyclicDependency>(inject<BaseService>("a")), "c2");
+        QVERIFY(regC2);
+        auto regB = context->registerService(service<BaseService>(inject<CyclicDependency>("c2")), "b");
+        QVERIFY(regB);
+
+        //a -> c1 -> b -> c2 -> a
+        auto regC1 = context->registerService(service<CyclicDependency>(inject<BaseService>("b")), "c1");
+        QVERIFY(!regC1);
+
+        //Without the cycle, registering c1 is fine:
+        regC1 = context->registerService(service<CyclicDependency>(), "c1");
+        QVERIFY(regC1);
+        QVERIFY(context->publish());
+    }
+
     void testWorkaroundCyclicDependencyWithServiceRef() {
         auto regBase = context->registerService(service<BaseService>(inject<CyclicDependency>()), "base");
         QVERIFY(regBase);
@@ -2813,6 +3470,147 @@ void testWatchConfigurationFileChangeWithError() {
         QCOMPARE(static_cast<BaseService*>(slotCard->my_bases[2])->objectName(), "base3");
     }
 
+    void testConcurrentCreation() {
+        auto regBase1 = context->registerService(service<Interface1,BaseService>() << withConcurrentCreation, "base1");
+        auto regBase2 = context->registerService(service<Interface1,BaseService2>() << withConcurrentCreation, "base2");
+        auto regDependent = context->registerService(service<DependentService>(inject<Interface1>("base1")) << withConcurrentCreation, "dependent");
+        auto regTimer = context->registerService(service<QTimer>() << withConcurrentCreation << propValue("interval", 4711), "timer");
+        RegistrationSlot<Interface1> base1{regBase1, this};
+        RegistrationSlot<Interface1> base2{regBase2, this};
+        RegistrationSlot<DependentService> dependent{regDependent, this};
+        RegistrationSlot<QTimer> timer{regTimer, this};
+        QVERIFY(context->publish());
+        QVERIFY(base1);
+        QVERIFY(base2);
+        QVERIFY(dependent);
+        QVERIFY(timer);
+        QCOMPARE(dynamic_cast<QObject*>(base1.last())->thread(), context->thread());
+        QCOMPARE(dynamic_cast<QObject*>(base2.last())->thread(), context->thread());
+        QCOMPARE(dependent->thread(), context->thread());
+        QCOMPARE(timer->thread(), context->thread());
+        QCOMPARE(dependent->dependency(), base1.last());
+        QCOMPARE(timer->interval(), 4711);
+    }
+
+    void testLazyCreation() {
+        auto regBase = context->registerService(service<Interface1,BaseService>() << withLazyCreation, "base");
+        auto regDependent = context->registerService(service<DependentService>(inject<Interface1>("base")) << withLazyCreation, "dependent");
+        auto regTimer = context->registerService(service<QTimer>() << withLazyCreation << propValue("interval", 4711), "timer");
+        RegistrationSlot<Interface1> base{regBase, this};
+        RegistrationSlot<QTimer> timer{regTimer, this};
+        unsigned publishedBefore = context->published();
+        QVERIFY(context->publish());
+        QCOMPARE(context->published(), publishedBefore);
+        QCOMPARE(context->pendingPublication(), 0);
+        QVERIFY(!base);
+        QVERIFY(!timer);
+
+        //Subscribing after publication demands the Service, together with its lazy dependencies:
+        RegistrationSlot<DependentService> dependent{regDependent, this};
+        QVERIFY(dependent);
+        QVERIFY(base);
+        QCOMPARE(dependent->dependency(), base.last());
+        QCOMPARE(context->published(), publishedBefore + 2);
+        QVERIFY(!timer);
+
+        //Injecting the Service demands it, too:
+        auto regHolder = context->registerService(service<BaseService>() << propValue(&BaseService::setTimer, regTimer), "holder");
+        RegistrationSlot<BaseService> holder{regHolder, this};
+        QVERIFY(context->publish());
+        QVERIFY(holder);
+        QVERIFY(timer);
+        QCOMPARE(holder->timer(), timer.last());
+        QCOMPARE(timer->interval(), 4711);
+        QCOMPARE(timer->parent(), context.get());
+        QCOMPARE(context->published(), publishedBefore + 4);
+    }
+
+    void testRegisterBatch() {
+        unsigned pendingChanges = 0;
+        connect(context.get(), &QApplicationContext::pendingPublicationChanged, this, [&pendingChanges] { ++pendingChanges;});
+        RegistrationBatch batch;
+        batch.add(service<Interface1,BaseService>(), "base").add(service<DependentService>(inject<Interface1>("base")), "dependent");
+        auto regs = context->registerServices(batch);
+        QCOMPARE(regs.size(), 2);
+        QCOMPARE(pendingChanges, 1);
+        QCOMPARE(context->pendingPublication(), 2);
+        auto regDependent = regs[1].as<DependentService,ServiceScope::SINGLETON>();
+        QVERIFY(regDependent);
+        RegistrationSlot<DependentService> dependent{regDependent, this};
+        QVERIFY(context->publish());
+        QVERIFY(dependent);
+        QVERIFY(dependent->dependency());
+    }
+
+    void testRegisterBatchIsAtomic() {
+        context->registerService(service<Interface1,BaseService>(), "base");
+        unsigned pendingChanges = 0;
+        connect(context.get(), &QApplicationContext::pendingPublicationChanged, this, [&pendingChanges] { ++pendingChanges;});
+        RegistrationBatch batch;
+        batch.add(service<QTimer>(), "timer").add(service<Interface1,BaseService2>(), "base");
+        QVERIFY(context->registerServices(batch).isEmpty());
+        QCOMPARE(pendingChanges, 0);
+        QVERIFY(!context->getRegistration("timer"));
+        QCOMPARE(context->pendingPublication(), 1);
+        //The name of the reverted registration may be used again:
+        QVERIFY(context->registerService(service<QTimer>(), "timer"));
+    }
+
+    void testFreeze() {
+        auto appContext = dynamic_cast<StandardApplicationContext*>(context.get());
+        QVERIFY(appContext);
+        auto regBase = context->registerService(service<Interface1,BaseService>(), "base");
+        QVERIFY(!appContext->isFrozen());
+        QVERIFY(appContext->freeze());
+        QVERIFY(appContext->isFrozen());
+        QVERIFY(!context->registerService(service<QTimer>(), "timer"));
+        QVERIFY(!regBase.registerAlias("alias"));
+        QCOMPARE(context->getRegistration("base").unwrap(), regBase.unwrap());
+        QVERIFY(!context->getRegistration("timer"));
+        QCOMPARE(context->getRegistrations().size(), 3); //The QCoreApplication, the QApplicationContext and 'base'.
+        QVERIFY(context->getRegistrations().contains(context->getRegistration("base")));
+        QCOMPARE(context->pendingPublication(), 1);
+
+        //Proxies that are created after freezing will be found, too:
+        auto proxy = context->getRegistration<Interface1>();
+        QCOMPARE(context->getRegistration<Interface1>().unwrap(), proxy.unwrap());
+        RegistrationSlot<Interface1> base{proxy, this};
+
+        //Freezing does not prevent publication:
+        QVERIFY(context->publish());
+        QVERIFY(base);
+        QCOMPARE(context->pendingPublication(), 0);
+    }
+
+    void testDestroyRegisteredObjectWhileFrozen() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        auto timer = new QTimer;
+        context->registerObject(timer, "timer");
+        QVERIFY(appContext->freeze());
+        auto registrationCount = context->getRegistrations().size();
+        std::atomic<bool> stop = false;
+        std::atomic<int> lookups = 0;
+        QThread* thread = QThread::create([this,&stop,&lookups] {
+            //Consults the snapshots without locking, while the registration of the timer is being removed:
+            while(!stop.load()) {
+                context->getRegistrations();
+                context->pendingPublication();
+                context->published();
+                ++lookups;
+            }
+        });
+        thread->start();
+        QVERIFY(QTest::qWaitFor([&lookups] { return lookups.load() > 0; }, 1000));
+        delete timer;
+        int lookupsAfterDestruction = lookups.load();
+        QVERIFY(QTest::qWaitFor([&lookups,lookupsAfterDestruction] { return lookups.load() > lookupsAfterDestruction; }, 1000));
+        stop.store(true);
+        QVERIFY(thread->wait(1000));
+        delete thread;
+        QVERIFY(!context->getRegistration("timer"));
+        QCOMPARE(context->getRegistrations().size(), registrationCount - 1);
+    }
+
     void testServiceGroupMissingExpression() {
         auto reg = context->registerService(serviceGroup("", "") << service<Interface1,BaseService>());
         QVERIFY(!reg);
@@ -3104,6 +3902,68 @@ void testWatchConfigurationFileChangeWithError() {
         delete thread;
     }
 
+    void testGetRegistrationInThreadWithoutEventLoop() {
+        ProxyRegistration<BaseService> reg;
+        QThread* thread = QThread::create([this,&reg] {
+            reg = context->getRegistration<BaseService>();
+        });
+        thread->start();
+        //This thread will not process any events while waiting:
+        QVERIFY(thread->wait(1000));
+        delete thread;
+        QVERIFY(reg.isValid());
+        QVERIFY(detail::hasCurrentThreadAffinity(reg.unwrap()));
+        QCOMPARE(context->getRegistration<BaseService>(), reg);
+    }
+
+    void testProxyRegistrationCreatedInThreadSubscribesInContextThread() {
+        context->registerService<BaseService>("base");
+        ProxyRegistration<BaseService> reg;
+        QThread* thread = QThread::create([this,&reg] {
+            reg = context->getRegistration<BaseService>();
+        });
+        thread->start();
+        QVERIFY(thread->wait(1000));
+        delete thread;
+        QVERIFY(reg.isValid());
+        RegistrationSlot<BaseService> slot{reg, this};
+        //No events have been processed since the proxy was created. Nevertheless, it must receive the publication:
+        QVERIFY(context->publish());
+        QCOMPARE(slot.invocationCount(), 1);
+        //The queued subscription must not deliver the service again:
+        QCoreApplication::processEvents();
+        QCOMPARE(slot.invocationCount(), 1);
+    }
+
+
+    void testPublicationOrderFollowsDependenciesAndRegistration() {
+        QObjectList publishedInOrder;
+        QObjectList destroyedInOrder;
+        auto published = [this,&publishedInOrder,&destroyedInOrder](QObject* service) {
+            publishedInOrder.push_back(service);
+            connect(service, &QObject::destroyed, this, [&destroyedInOrder](QObject* obj) { destroyedInOrder.push_back(obj);});
+        };
+        //The dependent service is registered before its dependency:
+        auto dependentReg = context->registerService(service<DependentService>(inject<Interface1>("base")), "dependent");
+        dependentReg.subscribe(this, published);
+        auto timerReg = context->registerService(service<QTimer>(), "timer");
+        timerReg.subscribe(this, published);
+        auto baseReg = context->registerService(service<Interface1,BaseService>(), "base");
+        baseReg.subscribe(this, published);
+        RegistrationSlot<DependentService> dependent{dependentReg, this};
+        RegistrationSlot<QTimer> timer{timerReg, this};
+        RegistrationSlot<Interface1> base{baseReg, this};
+        QVERIFY(context->publish());
+        //Independent services keep the order of registration. A service is published after its dependency:
+        QObject* baseObj = dynamic_cast<QObject*>(base.last());
+        QCOMPARE(publishedInOrder, (QObjectList{timer.last(), baseObj, dependent.last()}));
+
+        context.reset();
+        //Upon un-publication, a service is destroyed before its dependency. Independent services are destroyed in reverse order of registration:
+        QCOMPARE(destroyedInOrder.size(), 3);
+        QVERIFY(destroyedInOrder.indexOf(dependent.last()) < destroyedInOrder.indexOf(baseObj));
+        QVERIFY(destroyedInOrder.indexOf(timer.last()) < destroyedInOrder.indexOf(dependent.last()));
+    }
 
     void testPublishAll() {
         QObjectList destroyedInOrder;
@@ -367,6 +367,34 @@ private slots:
         QVERIFY(!reg2);
     }
 
+    void testConditionReflectsModifiedConfiguration() {
+        configuration->setValue("timer/singleShot", true);
+        auto reg1 = context->registerService(service<QTimer>(), "timer", Condition::Config["${timer/singleShot}"].exists());
+        QVERIFY(reg1);
+        QCOMPARE(context->getRegistration("timer"), reg1);
+
+        configuration->remove("timer/singleShot");
+        QVERIFY(!context->getRegistration("timer"));
+    }
+
+    void testConditionIsCachedWithConfigurationSnapshot() {
+        auto appContext = static_cast<StandardApplicationContext*>(context.get());
+        configuration->setValue("timer/singleShot", true);
+        //The snapshot will be built from the QSettings that has already been registered:
+        appContext->setConfigurationSnapshotEnabled(true);
+        auto reg1 = context->registerService(service<QTimer>(), "timer", Condition::Config["${timer/singleShot}"].exists());
+        QVERIFY(reg1);
+        QCOMPARE(context->getRegistration("timer"), reg1);
+
+        configuration->remove("timer/singleShot");
+        //The modification is not visible before the snapshot has been refreshed:
+        QCOMPARE(context->getRegistration("timer"), reg1);
+
+        //Refreshing the snapshot invalidates the cached result:
+        appContext->refreshConfiguration();
+        QVERIFY(!context->getRegistration("timer"));
+    }
+
 
 
 
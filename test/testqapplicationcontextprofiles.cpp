@@ -292,6 +292,17 @@ private slots:
         QCOMPARE(testBaseSlot->objectName(), "base-with-profile");
     }
 
+    void testFrozenLookupReflectsActiveProfiles() {
+        StandardApplicationContext* ctx = static_cast<StandardApplicationContext*>(context.get());
+        auto defaultBaseReg = context->registerService(service<BaseService>(), "base-with-profile", Condition::Profile == "default");
+        auto testBaseReg = context->registerService(service<BaseService>(), "base-with-profile", Condition::Profile == "test");
+        QVERIFY(ctx->freeze());
+        QCOMPARE(context->getRegistration("base-with-profile"), defaultBaseReg);
+
+        ctx->setActiveProfiles(Profiles{"test"});
+        QCOMPARE(context->getRegistration("base-with-profile"), testBaseReg);
+    }
+
     void testRegisterServiceForProfileNotIn() {
 
         auto commonBaseReg = context->registerService(service<BaseService>() << propValue("foo", "foo-common"), "base");